@@ -30,12 +30,12 @@ int main(int argc, char** argv) {
 
   for (const auto& M : I->modules()) {
     std::cout << "Module " << M.getName() << "\n";
-    // Examine all symbols in the module
-    for (const auto& Sym : M.symbols()) {
-      if (auto* Ref = Sym.getReferent<DataObject>(); Ref != nullptr) {
-        // If the symbol refers to data, print some information about it
-        std::cout << Sym.getName() << ":\t" << Ref->getAddress() << "\t"
-                  << Ref->getSize() << " bytes\n";
+    // Examine all data objects in the module
+    for (const auto& D : M.data()) {
+      // Print some information about each symbol referring to the data
+      for (const auto& Sym : M.symbolsFor(D)) {
+        std::cout << Sym.getName() << ":\t" << D.getAddress() << "\t"
+                  << D.getSize() << " bytes\n";
       }
     }
   }
@@ -18,6 +18,7 @@
 #include <gtirb/Export.hpp>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 
 /// \file Addr.hpp
 /// \brief Class gtirb::Addr and related functions.
@@ -230,4 +231,14 @@ template <typename T> bool containsAddr(const T& Object, Addr Ea) {
 
 } // namespace gtirb
 
+namespace std {
+/// \brief Hash an \ref gtirb::Addr, so that it can be used as a key in
+/// unordered containers.
+template <> struct hash<gtirb::Addr> {
+  size_t operator()(gtirb::Addr A) const noexcept {
+    return hash<uint64_t>()(static_cast<uint64_t>(A));
+  }
+};
+} // namespace std
+
 #endif // GTIRB_ADDR_H
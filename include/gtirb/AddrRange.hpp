@@ -0,0 +1,268 @@
+//===- AddrRange.hpp --------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_ADDR_RANGE_H
+#define GTIRB_ADDR_RANGE_H
+
+#include <gtirb/Addr.hpp>
+#include <gtirb/Export.hpp>
+#include <gsl/gsl>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+/// \file AddrRange.hpp
+/// \brief Classes gtirb::AddrRange and gtirb::AddrRangeSet.
+
+namespace gtirb {
+
+/// \class AddrRange
+///
+/// \brief A half-open range of addresses [lower(), upper()).
+class AddrRange {
+public:
+  /// \brief Construct an empty range at address 0.
+  constexpr AddrRange() = default;
+
+  /// \brief Construct the range [First, Limit).
+  ///
+  /// \param First  The first address in the range.
+  /// \param Limit  The address following the last address in the range. If
+  ///               it is less than \p First, the range is empty.
+  constexpr AddrRange(Addr First, Addr Limit) noexcept
+      : Lower(First), Upper(std::max(First, Limit)) {}
+
+  /// \brief Get the first address in the range.
+  constexpr Addr lower() const noexcept { return Lower; }
+
+  /// \brief Get the address following the last address in the range.
+  constexpr Addr upper() const noexcept { return Upper; }
+
+  /// \brief Get the number of addresses in the range.
+  constexpr uint64_t size() const noexcept {
+    return static_cast<uint64_t>(Upper - Lower);
+  }
+
+  /// \brief Check whether the range contains no addresses.
+  constexpr bool empty() const noexcept { return Lower == Upper; }
+
+  /// \brief Check whether the range contains an address.
+  constexpr bool contains(Addr A) const noexcept {
+    return Lower <= A && A < Upper;
+  }
+
+  /// \brief Check whether the range contains every address of another.
+  ///
+  /// An empty range is contained by every range.
+  constexpr bool contains(AddrRange R) const noexcept {
+    return R.empty() || (Lower <= R.Lower && R.Upper <= Upper);
+  }
+
+  /// \brief Check whether the range shares an address with another.
+  constexpr bool overlaps(AddrRange R) const noexcept {
+    return Lower < R.Upper && R.Lower < Upper && !empty() && !R.empty();
+  }
+
+  /// \brief Get the addresses common to this range and another.
+  ///
+  /// \return The intersection, which is empty if the ranges do not overlap.
+  constexpr AddrRange intersection(AddrRange R) const noexcept {
+    return AddrRange(std::max(Lower, R.Lower), std::min(Upper, R.Upper));
+  }
+
+  /// \brief Equality operator for \ref AddrRange.
+  friend constexpr bool operator==(AddrRange LHS, AddrRange RHS) noexcept {
+    return LHS.Lower == RHS.Lower && LHS.Upper == RHS.Upper;
+  }
+
+  /// \brief Inequality operator for \ref AddrRange.
+  friend constexpr bool operator!=(AddrRange LHS, AddrRange RHS) noexcept {
+    return !(LHS == RHS);
+  }
+
+  /// \brief Less-than operator for \ref AddrRange: orders by lower, then
+  /// upper address.
+  friend constexpr bool operator<(AddrRange LHS, AddrRange RHS) noexcept {
+    return LHS.Lower < RHS.Lower ||
+           (LHS.Lower == RHS.Lower && LHS.Upper < RHS.Upper);
+  }
+
+private:
+  Addr Lower;
+  Addr Upper;
+};
+
+/// \relates AddrRange
+/// \brief The range of addresses occupied by an object.
+///
+/// \tparam T       Any type that specifies a range of addresses via
+///                 getAddress() and getSize() methods (e.g. Section).
+///
+/// \param Object   The object to interrogate.
+///
+/// \return The range [getAddress(), addressLimit(Object)).
+template <typename T> AddrRange addressRange(const T& Object) {
+  return AddrRange(Object.getAddress(), addressLimit(Object));
+}
+
+/// \class AddrRangeSet
+///
+/// \brief A set of addresses, held as sorted, disjoint, non-adjacent
+/// ranges (\ref AddrRange).
+///
+/// Overlapping or adjacent ranges are coalesced on insertion, so a set has
+/// one canonical representation and equal sets compare equal.
+///
+/// A set of the addresses occupied by objects is built with \ref of:
+///
+/// \code
+///   AddrRangeSet Code = AddrRangeSet::of(M.sections());
+///   AddrRangeSet Loaded = M.getImageByteMap().addressRanges();
+///   AddrRangeSet Unloaded = Code - Loaded;
+/// \endcode
+class GTIRB_EXPORT_API AddrRangeSet {
+public:
+  /// \brief Construct an empty set.
+  AddrRangeSet() = default;
+
+  /// \brief Construct a set of the addresses in some ranges.
+  ///
+  /// \param Rs  The ranges, in any order. They may overlap or be empty.
+  explicit AddrRangeSet(std::vector<AddrRange> Rs);
+
+  /// \brief Construct a set of the addresses in some ranges.
+  ///
+  /// \param Rs  The ranges, in any order.
+  AddrRangeSet(std::initializer_list<AddrRange> Rs)
+      : AddrRangeSet(std::vector<AddrRange>(Rs)) {}
+
+  /// \brief Construct the set of the addresses occupied by some objects.
+  ///
+  /// \tparam RangeT  A range of objects which specify a range of addresses
+  ///                 via getAddress() and getSize() methods, or of pointers
+  ///                 to such objects.
+  ///
+  /// \param Objects  The objects. Sorting is skipped if they are already
+  ///                 ordered by address, as e.g. Module::sections() is.
+  ///
+  /// \return The set.
+  template <typename RangeT> static AddrRangeSet of(const RangeT& Objects) {
+    std::vector<AddrRange> Rs;
+    if constexpr (std::is_base_of_v<
+                      std::forward_iterator_tag,
+                      typename std::iterator_traits<decltype(
+                          std::begin(Objects))>::iterator_category>)
+      Rs.reserve(std::distance(std::begin(Objects), std::end(Objects)));
+    for (const auto& Object : Objects) {
+      if constexpr (std::is_pointer_v<std::decay_t<decltype(Object)>>)
+        Rs.push_back(addressRange(*Object));
+      else
+        Rs.push_back(addressRange(Object));
+    }
+    return AddrRangeSet(std::move(Rs));
+  }
+
+  /// \brief Get the ranges of the set, sorted, disjoint and non-adjacent.
+  gsl::span<const AddrRange> ranges() const { return Ranges; }
+
+  /// \brief Check whether the set contains no addresses.
+  bool empty() const { return Ranges.empty(); }
+
+  /// \brief Get the number of addresses in the set.
+  uint64_t size() const;
+
+  /// \brief Add the addresses of a range to the set.
+  ///
+  /// \param R  The range to add.
+  ///
+  /// \return void
+  void insert(AddrRange R);
+
+  /// \brief Check whether the set contains an address.
+  bool contains(Addr A) const { return find(A) != nullptr; }
+
+  /// \brief Check whether the set contains every address of a range.
+  bool contains(AddrRange R) const;
+
+  /// \brief Check whether the set shares an address with a range.
+  bool overlaps(AddrRange R) const;
+
+  /// \brief Find the range of the set containing an address.
+  ///
+  /// \param A  The address to look up.
+  ///
+  /// \return The range containing \p A, or null if there is none.
+  const AddrRange* find(Addr A) const;
+
+  /// \brief Find which of many addresses the set contains.
+  ///
+  /// \param Addrs  The addresses to look up, in any order. Ascending order
+  ///               is fastest: the lookup is then a single merge of the
+  ///               addresses with the ranges of the set, rather than a
+  ///               binary search for each address.
+  ///
+  /// \return The indices into \p Addrs of the addresses in the set, in
+  /// ascending order.
+  std::vector<size_t> findContained(gsl::span<const Addr> Addrs) const;
+
+  /// \brief Count how many of many addresses the set contains.
+  ///
+  /// \param Addrs  The addresses to look up, in any order. As for
+  ///               \ref findContained, ascending order is fastest.
+  ///
+  /// \return The number of elements of \p Addrs in the set.
+  size_t countContained(gsl::span<const Addr> Addrs) const;
+
+  /// \brief The addresses in either of two sets.
+  GTIRB_EXPORT_API friend AddrRangeSet operator|(const AddrRangeSet& LHS,
+                                                 const AddrRangeSet& RHS);
+
+  /// \brief The addresses in both of two sets.
+  GTIRB_EXPORT_API friend AddrRangeSet operator&(const AddrRangeSet& LHS,
+                                                 const AddrRangeSet& RHS);
+
+  /// \brief The addresses in one set but not another.
+  GTIRB_EXPORT_API friend AddrRangeSet operator-(const AddrRangeSet& LHS,
+                                                 const AddrRangeSet& RHS);
+
+  /// \brief Equality operator for \ref AddrRangeSet.
+  friend bool operator==(const AddrRangeSet& LHS, const AddrRangeSet& RHS) {
+    return LHS.Ranges == RHS.Ranges;
+  }
+
+  /// \brief Inequality operator for \ref AddrRangeSet.
+  friend bool operator!=(const AddrRangeSet& LHS, const AddrRangeSet& RHS) {
+    return !(LHS == RHS);
+  }
+
+private:
+  // Sorted, disjoint, non-adjacent and non-empty.
+  std::vector<AddrRange> Ranges;
+
+  // Append a range which starts at or after the last range of the set.
+  void append(AddrRange R);
+
+  // Call F with the index of each element of Addrs which is in the set, in
+  // ascending order.
+  template <typename Func>
+  void forEachContained(gsl::span<const Addr> Addrs, Func F) const;
+};
+
+} // namespace gtirb
+
+#endif // GTIRB_ADDR_RANGE_H
@@ -204,6 +204,31 @@ public:
 
   size_t getBytesAllocated() const { return BytesAllocated; }
 
+  /// Take ownership of all the memory of another allocator, which is left
+  /// empty. Memory allocated by either allocator remains valid.
+  void absorb(BumpPtrAllocatorImpl& Other) {
+    // The other allocator's slabs are kept as custom-sized slabs, since
+    // their sizes depend on their positions in its slab list. Only the used
+    // part of its current slab is recorded, so that a
+    // SpecificBumpPtrAllocator destroys only the objects in it.
+    CustomSizedSlabs.reserve(CustomSizedSlabs.size() + Other.GetNumSlabs());
+    for (size_t I = 0; I < Other.Slabs.size(); ++I) {
+      size_t Size = I + 1 == Other.Slabs.size()
+                        ? size_t(Other.CurPtr - (char*)Other.Slabs[I])
+                        : computeSlabSize(I);
+      CustomSizedSlabs.push_back(std::make_pair(Other.Slabs[I], Size));
+    }
+    CustomSizedSlabs.insert(CustomSizedSlabs.end(),
+                            Other.CustomSizedSlabs.begin(),
+                            Other.CustomSizedSlabs.end());
+    BytesAllocated += Other.BytesAllocated;
+
+    Other.CurPtr = Other.End = nullptr;
+    Other.BytesAllocated = 0;
+    Other.Slabs.clear();
+    Other.CustomSizedSlabs.clear();
+  }
+
   void setRedZoneSize(size_t NewSize) { RedZoneSize = NewSize; }
 
 private:
@@ -301,6 +326,12 @@ public:
   /// Allocate space for an array of objects without constructing them.
   T* Allocate(size_t num = 1) { return Allocator.Allocate<T>(num); }
 
+  /// Take ownership of the objects of another allocator, which is left
+  /// empty. They are destroyed along with the objects of this allocator.
+  void absorb(SpecificBumpPtrAllocator& Other) {
+    Allocator.absorb(Other.Allocator);
+  }
+
 private:
   /// Call the destructor of each allocated object and deallocate all but the
   /// current slab and reset the current pointer to the beginning of it, freeing
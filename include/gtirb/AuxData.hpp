@@ -19,12 +19,24 @@
 #include <gtirb/Block.hpp>
 #include <gtirb/Node.hpp>
 #include <boost/endian/conversion.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <gsl/gsl>
+#include <algorithm>
+#include <cstring>
 #include <deque>
+#include <iterator>
 #include <list>
 #include <map>
+#include <optional>
+#include <set>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -51,12 +63,17 @@ class Context;
 ///   - \ref UUID
 ///   - sequential containers
 ///   - mapping containers
+///   - multimapping containers (std::multimap, std::unordered_multimap)
+///   - set containers (std::set, std::unordered_set)
 ///   - std::tuple
+///   - std::optional
+///   - std::variant
 ///
 /// ### Supporting Additional Types
 ///
 /// Support for additional containers can be added by specializing \ref
-/// is_sequence or \ref is_mapping. Once serialized, the data does not
+/// is_sequence, \ref is_mapping, \ref is_multimapping or \ref is_set.
+/// Once serialized, the data does not
 /// depend on any specific container type, and its contents can be
 /// deserialized into different containers of the same kind (e.g. \c std::list
 /// to \c std::vector).
@@ -77,7 +94,13 @@ class Context;
 /// bytes to little-endian order and writing them directly to the byte
 /// array. Containers first write out the number of elements (as a uint64_t),
 /// then write each element one after another. Tuples are similar but omit
-/// the size, since it can be inferred from the type.
+/// the size, since it can be inferred from the type. An optional writes
+/// whether it holds a value (as a uint8_t), followed by the value if so. A
+/// variant writes the index of its alternative (as a uint64_t), followed by
+/// the alternative.
+///
+/// Because the element count comes first, hashed containers reserve their
+/// buckets before inserting any element, and so are rebuilt in one pass.
 
 /// @{
 
@@ -107,11 +130,37 @@ struct is_mapping<std::map<T, U>> : std::true_type {};
 template <class T, class U>
 struct is_mapping<std::unordered_map<T, U>> : std::true_type {};
 // Explicitly disable multimaps. Because they can contain multiple values for
-// a given key, they can't be used interchangeably with maps.
+// a given key, they can't be used interchangeably with maps. They are
+// serialized as "multimapping" instead.
 template <class T, class U>
 struct is_mapping<std::multimap<T, U>> : std::false_type {};
 template <class T, class U>
 struct is_mapping<std::unordered_multimap<T, U>> : std::false_type {};
+/// @endcond
+
+/// \struct is_multimapping
+///
+/// \brief Trait class that identifies whether T is a mapping container type
+/// which can hold several values for a key.
+///
+/// \see AUXDATA_GROUP
+template <class T> struct is_multimapping : std::false_type {};
+/// @cond INTERNAL
+template <class T, class U>
+struct is_multimapping<std::multimap<T, U>> : std::true_type {};
+template <class T, class U>
+struct is_multimapping<std::unordered_multimap<T, U>> : std::true_type {};
+/// @endcond
+
+/// \struct is_set
+///
+/// \brief Trait class that identifies whether T is a set container type.
+///
+/// \see AUXDATA_GROUP
+template <class T> struct is_set : std::false_type {};
+/// @cond INTERNAL
+template <class T> struct is_set<std::set<T>> : std::true_type {};
+template <class T> struct is_set<std::unordered_set<T>> : std::true_type {};
 
 template <class T> struct is_tuple : std::false_type {};
 template <class... Args>
@@ -151,6 +200,24 @@ template <class T, class Enable = void> struct auxdata_traits {
   static std::string type_id() = delete;
 };
 
+/// \brief Hash a serialized type name, as returned by
+/// \ref AuxData::typeName.
+///
+/// This is the 64-bit FNV-1a hash of the name. It is \c constexpr, so the
+/// hash of a literal type name can be computed at compile time.
+///
+/// \param Name  The type name to hash.
+///
+/// \return The hash of \p Name.
+constexpr uint64_t typeNameHash(std::string_view Name) {
+  uint64_t Hash = 0xcbf29ce484222325;
+  for (char C : Name) {
+    Hash ^= static_cast<unsigned char>(C);
+    Hash *= 0x100000001b3;
+  }
+  return Hash;
+}
+
 /// @cond INTERNAL
 template <class... Ts> struct TypeId {};
 
@@ -222,12 +289,8 @@ template <> struct auxdata_traits<std::string> {
     uint64_t Count;
     It = auxdata_traits<uint64_t>::fromBytes(Count, It);
 
-    Object.resize(Count);
-    std::for_each(Object.begin(), Object.end(), [&It](auto& elt) {
-      It = auxdata_traits<char>::fromBytes(elt, It);
-    });
-
-    return It;
+    Object.assign(It, It + Count);
+    return It + Count;
   }
 };
 
@@ -246,6 +309,57 @@ template <> struct auxdata_traits<InstructionRef> {
   }
 };
 
+// Identifies sequences which store elements with default_serialization
+// contiguously, so their elements can be copied in bulk. std::vector<bool> is
+// excluded because it does not store bools contiguously.
+template <class T> struct is_bulk_serializable : std::false_type {};
+template <class T>
+struct is_bulk_serializable<std::vector<T>>
+    : std::bool_constant<
+          std::is_base_of_v<default_serialization<T>, auxdata_traits<T>> &&
+          std::is_trivially_copyable_v<T> && !std::is_same_v<T, bool>> {};
+
+// Serialize and deserialize the elements of a std::vector by copying their
+// object representations in a single block, swapping bytes only on
+// big-endian hosts. The byte format is identical to serializing each element
+// with default_serialization.
+template <class T> struct bulk_serialization {
+  using Element = typename T::value_type;
+
+  static constexpr bool NeedsSwap =
+      sizeof(Element) > 1 &&
+      boost::endian::order::native != boost::endian::order::little;
+
+  static void toBytes(const T& Object, std::string& Bytes) {
+    size_t Offset = Bytes.size();
+    Bytes.resize(Offset + Object.size() * sizeof(Element));
+    char* Dest = Bytes.data() + Offset;
+    if constexpr (NeedsSwap) {
+      for (const Element& Elt : Object) {
+        Element Reversed = boost::endian::conditional_reverse<
+            boost::endian::order::little, boost::endian::order::native>(Elt);
+        std::memcpy(Dest, &Reversed, sizeof(Element));
+        Dest += sizeof(Element);
+      }
+    } else if (!Object.empty()) {
+      std::memcpy(Dest, Object.data(), Object.size() * sizeof(Element));
+    }
+  }
+
+  static from_iterator fromBytes(T& Object, from_iterator It, uint64_t Count) {
+    Object.resize(Count);
+    if (Count == 0)
+      return It;
+    std::memcpy(Object.data(), &*It, Count * sizeof(Element));
+    if constexpr (NeedsSwap) {
+      for (Element& Elt : Object)
+        boost::endian::conditional_reverse_inplace<
+            boost::endian::order::little, boost::endian::order::native>(Elt);
+    }
+    return It + Count * sizeof(Element);
+  }
+};
+
 template <class T>
 struct auxdata_traits<T, typename std::enable_if_t<is_sequence<T>::value>> {
   static std::string type_id() {
@@ -259,23 +373,50 @@ struct auxdata_traits<T, typename std::enable_if_t<is_sequence<T>::value>> {
     });
   }
 
+  // Appending to the string directly lets bulk serializable elements be
+  // copied in a single block.
+  static void toBytes(const T& Object, std::string& Bytes) {
+    if constexpr (is_bulk_serializable<T>::value) {
+      auxdata_traits<uint64_t>::toBytes(Object.size(),
+                                        std::back_inserter(Bytes));
+      bulk_serialization<T>::toBytes(Object, Bytes);
+    } else {
+      toBytes(Object, std::back_inserter(Bytes));
+    }
+  }
+
   static from_iterator fromBytes(T& Object, from_iterator It) {
     uint64_t Count;
     It = auxdata_traits<uint64_t>::fromBytes(Count, It);
 
-    Object.resize(Count);
-    std::for_each(Object.begin(), Object.end(), [&It](auto& Elt) {
-      It = auxdata_traits<typename T::value_type>::fromBytes(Elt, It);
-    });
-
-    return It;
+    if constexpr (is_bulk_serializable<T>::value) {
+      return bulk_serialization<T>::fromBytes(Object, It, Count);
+    } else {
+      Object.resize(Count);
+      std::for_each(Object.begin(), Object.end(), [&It](auto& Elt) {
+        It = auxdata_traits<typename T::value_type>::fromBytes(Elt, It);
+      });
+      return It;
+    }
   }
 };
 
+// Reserve space for the elements of a container being deserialized, if the
+// container supports it.
+template <class T, class Enable = void> struct reserve_traits {
+  static void reserve(T&, uint64_t) {}
+};
+template <class T>
+struct reserve_traits<
+    T, std::void_t<decltype(std::declval<T&>().reserve(uint64_t()))>> {
+  static void reserve(T& Object, uint64_t Count) { Object.reserve(Count); }
+};
+
 template <class T>
-struct auxdata_traits<T, typename std::enable_if_t<is_mapping<T>::value>> {
+struct auxdata_traits<T, typename std::enable_if_t<is_mapping<T>::value ||
+                                                   is_multimapping<T>::value>> {
   static std::string type_id() {
-    return "mapping<" +
+    return (is_mapping<T>::value ? "mapping<" : "multimapping<") +
            TypeId<typename T::key_type, typename T::mapped_type>::value() + ">";
   }
 
@@ -290,17 +431,65 @@ struct auxdata_traits<T, typename std::enable_if_t<is_mapping<T>::value>> {
   static from_iterator fromBytes(T& Object, from_iterator It) {
     uint64_t Count;
     It = auxdata_traits<uint64_t>::fromBytes(Count, It);
+    reserve_traits<T>::reserve(Object, Count);
 
     for (uint64_t i = 0; i < Count; i++) {
       typename T::key_type K;
       It = auxdata_traits<decltype(K)>::fromBytes(K, It);
       typename T::mapped_type V;
       It = auxdata_traits<decltype(V)>::fromBytes(V, It);
-      Object.emplace(std::move(K), std::move(V));
+      Object.emplace_hint(Object.end(), std::move(K), std::move(V));
     }
     return It;
   }
 };
+
+template <class T>
+struct auxdata_traits<T, typename std::enable_if_t<is_set<T>::value>> {
+  static std::string type_id() {
+    return "set<" + TypeId<typename T::key_type>::value() + ">";
+  }
+
+  static void toBytes(const T& Object, to_iterator It) {
+    auxdata_traits<uint64_t>::toBytes(Object.size(), It);
+    std::for_each(Object.begin(), Object.end(), [&It](const auto& Elt) {
+      auxdata_traits<typename T::key_type>::toBytes(Elt, It);
+    });
+  }
+
+  static from_iterator fromBytes(T& Object, from_iterator It) {
+    uint64_t Count;
+    It = auxdata_traits<uint64_t>::fromBytes(Count, It);
+    reserve_traits<T>::reserve(Object, Count);
+
+    for (uint64_t i = 0; i < Count; i++) {
+      typename T::key_type K;
+      It = auxdata_traits<decltype(K)>::fromBytes(K, It);
+      Object.emplace_hint(Object.end(), std::move(K));
+    }
+    return It;
+  }
+};
+
+template <class T> struct auxdata_traits<std::optional<T>> {
+  static std::string type_id() { return "option<" + TypeId<T>::value() + ">"; }
+
+  static void toBytes(const std::optional<T>& Object, to_iterator It) {
+    auxdata_traits<uint8_t>::toBytes(Object.has_value(), It);
+    if (Object)
+      auxdata_traits<T>::toBytes(*Object, It);
+  }
+
+  static from_iterator fromBytes(std::optional<T>& Object, from_iterator It) {
+    uint8_t HasValue;
+    It = auxdata_traits<uint8_t>::fromBytes(HasValue, It);
+    if (!HasValue) {
+      Object.reset();
+      return It;
+    }
+    return auxdata_traits<T>::fromBytes(Object.emplace(), It);
+  }
+};
 /// @endcond
 
 /// @cond INTERNAL
@@ -346,18 +535,380 @@ struct auxdata_traits<T, typename std::enable_if_t<is_tuple<T>::value>>
 /// @endcond
 
 /// @cond INTERNAL
+template <class... Ts> struct auxdata_traits<std::variant<Ts...>> {
+  using Variant = std::variant<Ts...>;
+
+  static std::string type_id() {
+    return "variant<" + TypeId<Ts...>::value() + ">";
+  }
+
+  static void toBytes(const Variant& Object, to_iterator It) {
+    auxdata_traits<uint64_t>::toBytes(Object.index(), It);
+    std::visit(
+        [&It](const auto& Alt) {
+          auxdata_traits<std::decay_t<decltype(Alt)>>::toBytes(Alt, It);
+        },
+        Object);
+  }
+
+  static from_iterator fromBytes(Variant& Object, from_iterator It) {
+    uint64_t Index;
+    It = auxdata_traits<uint64_t>::fromBytes(Index, It);
+    static_for(
+        [&Object, &It, Index](auto i) {
+          if (i == Index)
+            It = auxdata_traits<std::variant_alternative_t<i, Variant>>::
+                fromBytes(Object.template emplace<i>(), It);
+        },
+        std::make_index_sequence<sizeof...(Ts)>{});
+    return It;
+  }
+};
+/// @endcond
+
+/// @cond INTERNAL
+// Type names are built once per type and cached, as are their hashes.
 template <class T> struct TypeId<T> {
-  static std::string value() { return auxdata_traits<T>::type_id(); }
+  static const std::string& value() {
+    static const std::string Name = auxdata_traits<T>::type_id();
+    return Name;
+  }
+
+  static uint64_t hash() {
+    static const uint64_t Hash = typeNameHash(value());
+    return Hash;
+  }
 };
 
 template <class T, class... Ts> struct TypeId<T, Ts...> {
-  static std::string value() {
-    return auxdata_traits<T>::type_id() + "," + TypeId<Ts...>::value();
+  static const std::string& value() {
+    static const std::string Name =
+        auxdata_traits<T>::type_id() + "," + TypeId<Ts...>::value();
+    return Name;
+  }
+};
+/// @endcond
+
+/// @cond INTERNAL
+// Identifies types whose traits can also append to a std::string directly,
+// rather than through a to_iterator.
+template <class T, class Enable = void>
+struct has_string_serialization : std::false_type {};
+template <class T>
+struct has_string_serialization<
+    T, std::void_t<decltype(auxdata_traits<T>::toBytes(
+           std::declval<const T&>(), std::declval<std::string&>()))>>
+    : std::true_type {};
+
+// Serialize Object, appending its bytes to Bytes.
+template <class T> void appendBytes(const T& Object, std::string& Bytes) {
+  if constexpr (has_string_serialization<T>::value)
+    auxdata_traits<T>::toBytes(Object, Bytes);
+  else
+    auxdata_traits<T>::toBytes(Object, std::back_inserter(Bytes));
+}
+/// @endcond
+
+/// @cond INTERNAL
+// Identifies types whose serialized representation has a fixed size, so that
+// they can be read directly from serialized bytes without decoding the
+// enclosing container.
+template <class T, class Enable = void> struct fixed_width_traits {
+  static constexpr bool IsFixedWidth = false;
+};
+
+template <class T>
+struct fixed_width_traits<
+    T, std::enable_if_t<
+           std::is_base_of_v<default_serialization<T>, auxdata_traits<T>> &&
+           std::is_trivially_copyable_v<T>>> {
+  static constexpr bool IsFixedWidth = true;
+  static constexpr size_t Size = sizeof(T);
+
+  static T read(const char* Bytes) {
+    T Object;
+    std::memcpy(&Object, Bytes, sizeof(T));
+    // Data stored as little-endian.
+    boost::endian::conditional_reverse_inplace<boost::endian::order::little,
+                                               boost::endian::order::native>(
+        Object);
+    return Object;
+  }
+};
+
+template <class T, class U>
+struct fixed_width_traits<
+    std::pair<T, U>, std::enable_if_t<fixed_width_traits<T>::IsFixedWidth &&
+                                      fixed_width_traits<U>::IsFixedWidth>> {
+  static constexpr bool IsFixedWidth = true;
+  static constexpr size_t Size =
+      fixed_width_traits<T>::Size + fixed_width_traits<U>::Size;
+
+  static std::pair<T, U> read(const char* Bytes) {
+    return {fixed_width_traits<T>::read(Bytes),
+            fixed_width_traits<U>::read(Bytes + fixed_width_traits<T>::Size)};
   }
 };
+
+template <class... Ts>
+struct fixed_width_traits<
+    std::tuple<Ts...>,
+    std::enable_if_t<(fixed_width_traits<Ts>::IsFixedWidth && ...)>> {
+  static constexpr bool IsFixedWidth = true;
+  static constexpr size_t Size = (fixed_width_traits<Ts>::Size + ... + 0);
+
+  static std::tuple<Ts...> read(const char* Bytes) {
+    std::tuple<Ts...> Object;
+    static_for(
+        [&Bytes, &Object](auto i) {
+          auto& F = std::get<i>(Object);
+          using FieldTy = std::remove_reference_t<decltype(F)>;
+          F = fixed_width_traits<FieldTy>::read(Bytes);
+          Bytes += fixed_width_traits<FieldTy>::Size;
+        },
+        std::make_index_sequence<sizeof...(Ts)>{});
+    return Object;
+  }
+};
+
+// The element type presented by an AuxDataView<T>.
+template <class T, class Enable = void> struct view_traits {};
+template <class T>
+struct view_traits<T, std::enable_if_t<is_sequence<T>::value>> {
+  using Element = typename T::value_type;
+};
+template <class T>
+struct view_traits<T, std::enable_if_t<is_mapping<T>::value>> {
+  using Element = std::pair<typename T::key_type, typename T::mapped_type>;
+};
 /// @endcond
 
+/// \class AuxDataView
+///
+/// \brief A read-only view of a serialized sequence or mapping of
+/// fixed-width elements.
+///
+/// Elements are decoded individually from the serialized bytes on each
+/// access, so a view provides random access to a large table without
+/// decoding the whole table or allocating memory. Supported element types
+/// are integers, Addr, UUID, and pairs and tuples of these. Mapping views
+/// present their entries as key-value pairs in serialized order, which is
+/// sorted by key for tables created from a \c std::map.
+///
+/// A view does not own the bytes it reads, which must outlive it.
+///
+/// \tparam T  The container type that the bytes were serialized from, e.g.
+///            \c std::vector<Addr> or \c std::map<Addr, uint64_t>.
+///
+/// \see AUXDATA_GROUP
+template <class T> class AuxDataView {
+  using Element = typename view_traits<T>::Element;
+  using Traits = fixed_width_traits<Element>;
+  static_assert(Traits::IsFixedWidth,
+                "AuxDataView requires elements of a fixed serialized size");
+
+  AuxDataView(const char* D, size_t C) : Data(D), Count(C) {}
+
+public:
+  /// \brief The type of the elements of the view.
+  using value_type = Element;
+
+  /// \brief Random access iterator over the elements of the view.
+  ///
+  /// Dereferencing the iterator decodes an element and returns it by value.
+  class iterator
+      : public boost::iterator_facade<iterator, Element,
+                                      std::random_access_iterator_tag,
+                                      Element> {
+  public:
+    iterator() = default;
+
+  private:
+    iterator(const char* P) : Ptr(P) {}
+
+    friend class AuxDataView;
+    friend class boost::iterator_core_access;
+
+    Element dereference() const { return Traits::read(Ptr); }
+    bool equal(const iterator& Other) const { return Ptr == Other.Ptr; }
+    void increment() { Ptr += Traits::Size; }
+    void decrement() { Ptr -= Traits::Size; }
+    void advance(std::ptrdiff_t N) { Ptr += N * std::ptrdiff_t(Traits::Size); }
+    std::ptrdiff_t distance_to(const iterator& Other) const {
+      return (Other.Ptr - Ptr) / std::ptrdiff_t(Traits::Size);
+    }
+
+    const char* Ptr{nullptr};
+  };
+
+  /// \brief Create a view over serialized bytes.
+  ///
+  /// \param Bytes  The serialized contents of an AuxData holding a \p T,
+  ///               such as the \c data field of an AuxData protobuf message.
+  ///               Any bytes following the serialized table are ignored.
+  ///
+  /// \return The view, or \c std::nullopt if \p Bytes is too short to hold
+  /// the table it describes.
+  static std::optional<AuxDataView>
+  fromBytes(gsl::span<const std::byte> Bytes) {
+    const size_t HeaderSize = sizeof(uint64_t);
+    if (static_cast<size_t>(Bytes.size()) < HeaderSize)
+      return std::nullopt;
+    auto* Begin = reinterpret_cast<const char*>(Bytes.data());
+    uint64_t Count = fixed_width_traits<uint64_t>::read(Begin);
+    if (Count > (static_cast<size_t>(Bytes.size()) - HeaderSize) / Traits::Size)
+      return std::nullopt;
+    return AuxDataView(Begin + HeaderSize, Count);
+  }
+
+  /// \brief Return the number of elements in the view.
+  size_t size() const { return Count; }
+
+  /// \brief Return whether the view has no elements.
+  bool empty() const { return Count == 0; }
+
+  /// \brief Decode the element at an index.
+  ///
+  /// \param I  The index of the element, which must be less than size().
+  ///
+  /// \return The decoded element.
+  Element operator[](size_t I) const {
+    return Traits::read(Data + I * Traits::Size);
+  }
+
+  /// \brief Return an iterator to the first element.
+  iterator begin() const { return iterator(Data); }
+
+  /// \brief Return an iterator to the element following the last element.
+  iterator end() const { return iterator(Data + Count * Traits::Size); }
+
+private:
+  const char* Data;
+  size_t Count;
+};
+
 /// @cond INTERNAL
+// An index over serialized contents, built from them on first use.
+class AuxDataIndex {
+public:
+  virtual ~AuxDataIndex() = default;
+};
+
+// An index of a serialized mapping: the decoded key of each entry with the
+// offset of its value, sorted by key. Of several entries with equal keys
+// only the first is found, as only the first is kept when decoding. If the
+// entries do not fit in the serialized bytes, the index is left empty.
+template <class Key, class Value> class mapping_index : public AuxDataIndex {
+public:
+  explicit mapping_index(const std::string& Bytes) {
+    if (Bytes.size() < sizeof(uint64_t))
+      return;
+    uint64_t Count;
+    from_iterator It =
+        auxdata_traits<uint64_t>::fromBytes(Count, Bytes.begin());
+
+    std::vector<std::pair<Key, uint64_t>> Found;
+    // Count is not trusted: every entry takes at least one byte.
+    Found.reserve(std::min<uint64_t>(Count, Bytes.size()));
+    for (uint64_t I = 0; I < Count; ++I) {
+      if (!fits<Key>(Bytes, It))
+        return;
+      Key K;
+      It = auxdata_traits<Key>::fromBytes(K, It);
+      if (!fits<Value>(Bytes, It))
+        return;
+      uint64_t ValueOffset = It - Bytes.begin();
+      if constexpr (fixed_width_traits<Value>::IsFixedWidth) {
+        It += fixed_width_traits<Value>::Size;
+      } else {
+        Value V;
+        It = auxdata_traits<Value>::fromBytes(V, It);
+      }
+      if (static_cast<size_t>(It - Bytes.begin()) > Bytes.size())
+        return;
+      Found.emplace_back(std::move(K), ValueOffset);
+    }
+    std::stable_sort(
+        Found.begin(), Found.end(),
+        [](const auto& LHS, const auto& RHS) { return LHS.first < RHS.first; });
+    Entries = std::move(Found);
+  }
+
+  // Binary-search the keys, decoding only the value found from Bytes, which
+  // must be the bytes the index was built from.
+  std::optional<Value> lookup(const std::string& Bytes, const Key& K) const {
+    auto It = std::lower_bound(
+        Entries.begin(), Entries.end(), K,
+        [](const auto& Entry, const Key& Sought) {
+          return Entry.first < Sought;
+        });
+    if (It == Entries.end() || K < It->first)
+      return std::nullopt;
+    Value V;
+    auxdata_traits<Value>::fromBytes(V, Bytes.begin() + It->second);
+    return V;
+  }
+
+private:
+  // Whether a T starting at It may lie within Bytes. Only fixed-width types
+  // can be checked before they are decoded; others are checked after.
+  template <class T>
+  static bool fits(const std::string& Bytes, from_iterator It) {
+    if (static_cast<size_t>(It - Bytes.begin()) > Bytes.size())
+      return false;
+    if constexpr (fixed_width_traits<T>::IsFixedWidth)
+      return static_cast<size_t>(Bytes.end() - It) >=
+             fixed_width_traits<T>::Size;
+    return true;
+  }
+
+  std::vector<std::pair<Key, uint64_t>> Entries;
+};
+
+// Identifies sequences of tuples, whose fields \ref AuxData::column can
+// extract.
+template <class T, class Enable = void>
+struct is_columnar : std::false_type {};
+template <class T>
+struct is_columnar<T, std::enable_if_t<is_sequence<T>::value>>
+    : is_tuple<typename T::value_type> {};
+
+// The columns of a serialized sequence of tuples: each field of every row,
+// decoded once into a vector per field, so that fields can be extracted
+// without building the rows.
+template <class Row> class column_index;
+template <class... Fields>
+class column_index<std::tuple<Fields...>> : public AuxDataIndex {
+public:
+  explicit column_index(const std::string& Bytes) {
+    uint64_t Count;
+    from_iterator It =
+        auxdata_traits<uint64_t>::fromBytes(Count, Bytes.begin());
+    // Count is not trusted: every row takes at least one byte.
+    uint64_t Reserved = std::min<uint64_t>(Count, Bytes.size());
+    std::apply([Reserved](auto&... C) { (C.reserve(Reserved), ...); },
+               Columns);
+    for (uint64_t I = 0; I < Count; ++I)
+      std::apply([&It](auto&... C) { ((It = readField(C, It)), ...); },
+                 Columns);
+  }
+
+  template <size_t I> const auto& column() const {
+    return std::get<I>(Columns);
+  }
+
+private:
+  template <class F>
+  static from_iterator readField(std::vector<F>& Column, from_iterator It) {
+    F Value;
+    It = auxdata_traits<F>::fromBytes(Value, It);
+    Column.push_back(std::move(Value));
+    return It;
+  }
+
+  std::tuple<std::vector<Fields>...> Columns;
+};
+
 class AuxDataImpl {
 public:
   virtual ~AuxDataImpl() = default;
@@ -375,7 +926,7 @@ public:
   AuxDataTemplate(T&& Val) : Object(std::move(Val)){};
 
   void toBytes(std::string& Bytes) const override {
-    auxdata_traits<T>::toBytes(Object, std::back_inserter(Bytes));
+    appendBytes(Object, Bytes);
   }
 
   void fromBytes(const std::string& Bytes) override {
@@ -428,14 +979,15 @@ public:
   template <typename T> T* get() {
     if (!this->RawBytes.empty()) {
       // Reconstruct from deserialized data
-      this->Impl = std::make_unique<AuxDataTemplate<T>>();
-
-      if (this->Impl->typeName() != this->TypeName) {
+      if (!this->storesType<T>()) {
         return nullptr;
       }
 
-      this->Impl->fromBytes(this->RawBytes);
+      auto Decoded = std::make_unique<AuxDataTemplate<T>>();
+      Decoded->fromBytes(this->RawBytes);
+      this->Impl = std::move(Decoded);
       this->RawBytes.clear();
+      this->RawIndex.reset();
       this->TypeName.clear();
     } else if (this->Impl == nullptr || typeid(T) != this->Impl->storedType()) {
       return nullptr;
@@ -444,6 +996,114 @@ public:
     return static_cast<T*>(this->Impl->get());
   }
 
+  /// \brief Get a read-only view of serialized contents.
+  ///
+  /// Unlike \ref get, this does not decode the contents, so it is suitable
+  /// for random access into large tables. Views are only available while the
+  /// AuxData holds serialized bytes, i.e. after it has been loaded and before
+  /// \ref get has been called for it, which invalidates any views.
+  ///
+  /// \tparam T  The expected type of the contents: a sequence or mapping of
+  ///            fixed-width elements (see \ref AuxDataView).
+  ///
+  /// \returns A view of the contents, or \c std::nullopt if the AuxData does
+  /// not hold serialized contents of type \p T.
+  template <typename T> std::optional<AuxDataView<T>> view() const {
+    if (this->RawBytes.empty() || !this->storesType<T>())
+      return std::nullopt;
+    return AuxDataView<T>::fromBytes(gsl::as_bytes(
+        gsl::span<const char>(this->RawBytes.data(), this->RawBytes.size())));
+  }
+
+  /// \brief Look up a key in mapping contents without decoding them.
+  ///
+  /// Serialized contents are not decoded into a \p T. Instead, the first
+  /// lookup decodes their keys into an index, sorted by key, which later
+  /// lookups binary-search, so that each decodes only the value found. The
+  /// index is kept until the contents are decoded by \ref get or replaced.
+  /// Decoded contents are searched directly. The serialized form is the
+  /// usual one, so this works for any AuxData holding a mapping.
+  ///
+  /// As the index is built by a \c const member function, concurrent
+  /// lookups in the same AuxData must be synchronized by the caller.
+  ///
+  /// \tparam T  The expected type of the contents, a mapping.
+  ///
+  /// \param K  The key to look up.
+  ///
+  /// \returns A copy of the value for \p K, or \c std::nullopt if there is
+  /// no such key or the AuxData does not contain a \p T.
+  template <typename T>
+  std::optional<typename T::mapped_type>
+  lookup(const typename T::key_type& K) const {
+    static_assert(is_mapping<T>::value, "lookup requires a mapping type");
+    if (this->RawBytes.empty()) {
+      if (this->Impl == nullptr || typeid(T) != this->Impl->storedType())
+        return std::nullopt;
+      const T& Object = *static_cast<const T*>(this->Impl->get());
+      auto It = Object.find(K);
+      if (It == Object.end())
+        return std::nullopt;
+      return It->second;
+    }
+
+    if (!this->storesType<T>())
+      return std::nullopt;
+    using Index =
+        mapping_index<typename T::key_type, typename T::mapped_type>;
+    const auto* I = dynamic_cast<const Index*>(this->RawIndex.get());
+    if (I == nullptr) {
+      auto Built = std::make_unique<Index>(this->RawBytes);
+      I = Built.get();
+      this->RawIndex = std::move(Built);
+    }
+    return I->lookup(this->RawBytes, K);
+  }
+
+  /// \brief Extract one field of each row of a sequence of tuples.
+  ///
+  /// Serialized contents are not decoded into a \p T. Instead, the first
+  /// extraction decodes every field into a column of its own, which later
+  /// extractions of any field copy from. The columns are kept until the
+  /// contents are decoded by \ref get or replaced. Decoded contents are
+  /// copied from directly.
+  ///
+  /// As the columns are built by a \c const member function, concurrent
+  /// extractions from the same AuxData must be synchronized by the caller.
+  ///
+  /// \tparam T  The expected type of the contents, a sequence of tuples.
+  /// \tparam I  The index of the field to extract.
+  ///
+  /// \returns The \p I th field of every row, in order, or \c std::nullopt
+  /// if the AuxData does not contain a \p T.
+  template <typename T, size_t I>
+  std::optional<std::vector<std::tuple_element_t<I, typename T::value_type>>>
+  column() const {
+    static_assert(is_columnar<T>::value,
+                  "column requires a sequence of tuples");
+    if (this->RawBytes.empty()) {
+      if (this->Impl == nullptr || typeid(T) != this->Impl->storedType())
+        return std::nullopt;
+      const T& Object = *static_cast<const T*>(this->Impl->get());
+      std::vector<std::tuple_element_t<I, typename T::value_type>> Result;
+      Result.reserve(Object.size());
+      for (const auto& Row : Object)
+        Result.push_back(std::get<I>(Row));
+      return Result;
+    }
+
+    if (!this->storesType<T>())
+      return std::nullopt;
+    using Index = column_index<typename T::value_type>;
+    const auto* Columns = dynamic_cast<const Index*>(this->RawIndex.get());
+    if (Columns == nullptr) {
+      auto Built = std::make_unique<Index>(this->RawBytes);
+      Columns = Built.get();
+      this->RawIndex = std::move(Built);
+    }
+    return Columns->template column<I>();
+  }
+
   /// \brief A string representation of the type of the stored data.
   ///
   /// \returns The type name, or an empty string if no value is stored.
@@ -455,6 +1115,35 @@ public:
     }
   }
 
+  /// \brief Check whether the stored data has a given type.
+  ///
+  /// For serialized data this compares the hash of the serialized type
+  /// name with the hash of the name of \p T, computed once per type, before
+  /// comparing the names themselves. It does not decode the data.
+  ///
+  /// \tparam T  The type to check for.
+  ///
+  /// \returns \c true if the AuxData stores a \p T, otherwise \c false.
+  template <typename T> bool storesType() const {
+    if (!this->RawBytes.empty())
+      return this->TypeHash == TypeId<T>::hash() &&
+             this->TypeName == TypeId<T>::value();
+    return this->Impl != nullptr && typeid(T) == this->Impl->storedType();
+  }
+
+  /// \brief Get the hash of the name of the stored type.
+  ///
+  /// This can be compared with \ref typeNameHash of a name such as
+  /// "sequence<Addr>".
+  ///
+  /// \returns The hash of the type name, or the hash of an empty string if
+  /// no value is stored.
+  uint64_t typeHash() const {
+    if (this->Impl)
+      return typeNameHash(this->Impl->typeName());
+    return this->TypeHash;
+  }
+
   /// \brief Initialize an AuxData from a protobuf message.
   ///
   /// \param <unnamed>   Not used.
@@ -463,6 +1152,15 @@ public:
   GTIRB_EXPORT_API friend void fromProtobuf(Context&, AuxData& Result,
                                             const proto::AuxData& Message);
 
+  /// \brief Initialize an AuxData from a protobuf message, taking its
+  /// serialized contents without copying them.
+  ///
+  /// \param <unnamed>   Not used.
+  /// \param Message     The protobuf message from which to deserialize.
+  /// \param[out] Result  The AuxData to initialize.
+  GTIRB_EXPORT_API friend void fromProtobuf(Context&, AuxData& Result,
+                                            proto::AuxData&& Message);
+
   /// \brief Serialize into a protobuf message.
   ///
   /// \param <unnamed>     The AuxData to serialize.
@@ -471,11 +1169,30 @@ public:
   GTIRB_EXPORT_API friend proto::AuxData toProtobuf(const AuxData&);
 
 private:
+  // Set TypeName and TypeHash from a serialized type name.
+  void setSerializedType(const std::string& SerializedTypeName) {
+    this->TypeName = SerializedTypeName;
+    this->TypeHash = typeNameHash(this->TypeName);
+  }
+
   std::unique_ptr<AuxDataImpl> Impl;
+  // Serialized contents, as loaded and not yet decoded by get<T>().
   std::string RawBytes;
+  // An index over RawBytes, built on first use.
+  mutable std::unique_ptr<AuxDataIndex> RawIndex;
+  // The name of the serialized type, and its hash.
   std::string TypeName;
+  uint64_t TypeHash{typeNameHash("")};
 };
 
+/// \relates AuxData
+/// \brief Serialize an AuxData into a protobuf message.
+///
+/// \param T   The AuxData to serialize.
+///
+/// \return A protobuf message representing the AuxData.
+GTIRB_EXPORT_API proto::AuxData toProtobuf(const AuxData& T);
+
 /// @}
 // (end \defgroup AUXDATA_GROUP)
 
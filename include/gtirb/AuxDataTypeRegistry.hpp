@@ -0,0 +1,112 @@
+//===- AuxDataTypeRegistry.hpp ----------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_AUXDATA_TYPE_REGISTRY_H
+#define GTIRB_AUXDATA_TYPE_REGISTRY_H
+
+#include <gtirb/AuxData.hpp>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+/// \file AuxDataTypeRegistry.hpp
+/// \ingroup AUXDATA_GROUP
+/// \brief Class gtirb::AuxDataTypeRegistry.
+/// \see AUXDATA_GROUP
+
+namespace gtirb {
+
+/// \class AuxDataTypeRegistry
+///
+/// \brief Maps serialized \ref AuxData type names to the C++ types that
+/// decode them.
+///
+/// A tool registers the types of the tables it knows about once, and can
+/// then decode tables it loads without naming their types at compile time:
+///
+/// \code
+///   AuxDataTypeRegistry Registry;
+///   Registry.registerType<std::map<Addr, uint64_t>>();
+///   Registry.registerType<std::vector<std::tuple<std::string, Addr>>>();
+///   for (auto& [Name, Table] : IR->aux_data())
+///     if (const auto* Entry = Registry.findFor(Table))
+///       Entry->Decode(Table);
+/// \endcode
+///
+/// Entries are keyed by \ref typeNameHash of the type name, so a lookup
+/// hashes the name once and compares integers. Registries are ordinary
+/// objects; there is no global registry.
+///
+/// \see AUXDATA_GROUP
+class AuxDataTypeRegistry {
+public:
+  /// \brief A registered type.
+  struct Entry {
+    /// \brief The serialized type name.
+    std::string TypeName;
+    /// \brief The C++ type which the type name decodes to.
+    const std::type_info* Type;
+    /// \brief Decode an AuxData of this type in place, as if by
+    /// AuxData::get. Returns \c false if it does not hold this type.
+    bool (*Decode)(AuxData&);
+  };
+
+  /// \brief Register a type.
+  ///
+  /// Registering a type whose name is already registered replaces the
+  /// earlier entry, so that, e.g., a \c std::list can be preferred over a
+  /// \c std::vector for "sequence<...>".
+  ///
+  /// \tparam T  The type to register.
+  template <typename T> void registerType() {
+    Entries[TypeId<T>::hash()] =
+        Entry{TypeId<T>::value(), &typeid(T),
+              [](AuxData& A) { return A.get<T>() != nullptr; }};
+  }
+
+  /// \brief Find the entry for a type name.
+  ///
+  /// \param TypeName  A serialized type name.
+  ///
+  /// \return The entry, or null if the type is not registered.
+  const Entry* find(const std::string& TypeName) const {
+    return find(typeNameHash(TypeName), TypeName);
+  }
+
+  /// \brief Find the entry for the type stored in an AuxData.
+  ///
+  /// \param A  The AuxData, which need not be decoded.
+  ///
+  /// \return The entry, or null if the type is not registered.
+  const Entry* findFor(const AuxData& A) const {
+    return find(A.typeHash(), A.typeName());
+  }
+
+  /// \brief Get the number of registered types.
+  size_t size() const { return Entries.size(); }
+
+private:
+  const Entry* find(uint64_t Hash, const std::string& Name) const {
+    auto It = Entries.find(Hash);
+    if (It == Entries.end() || It->second.TypeName != Name)
+      return nullptr;
+    return &It->second;
+  }
+
+  std::unordered_map<uint64_t, Entry> Entries;
+};
+
+} // namespace gtirb
+
+#endif // GTIRB_AUXDATA_TYPE_REGISTRY_H
@@ -0,0 +1,146 @@
+//===- BlockColumns.hpp -----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_BLOCK_COLUMNS_H
+#define GTIRB_BLOCK_COLUMNS_H
+
+#include <gtirb/Addr.hpp>
+#include <gtirb/Block.hpp>
+#include <gtirb/CFG.hpp>
+#include <gtirb/Export.hpp>
+#include <gsl/gsl>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/// \file BlockColumns.hpp
+/// \ingroup CFG_GROUP
+/// \brief Class gtirb::BlockColumns.
+/// \see CFG_GROUP
+
+namespace gtirb {
+
+/// \class BlockColumns
+///
+/// \brief The blocks (\ref Block) of a \ref CFG in columnar form, for
+/// scans.
+///
+/// The address, size, exit kind and decode mode of each block are held in
+/// separate arrays ("columns"), sorted by address. A block is identified by
+/// its \ref Index, its position in the columns. A scan which reads one or
+/// two attributes of many blocks, such as finding all the call blocks in an
+/// address range, reads only those columns from contiguous memory: about 25
+/// bytes per block, rather than a whole Block node and CFG vertex.
+///
+/// \code
+///   const BlockColumns& Columns = Module.blockColumns();
+///   auto [Begin, End] = Columns.findBlocks(Lower, Upper);
+///   auto Exits = Columns.exitKinds();
+///   for (auto I = Begin; I < End; ++I)
+///     if (Exits[I] == Block::Exit::Call)
+///       ...
+/// \endcode
+///
+/// A \ref Module owns the columns of its blocks, built on first use by
+/// \ref Module::blockColumns and discarded when its CFG may change. The
+/// blocks themselves remain Block nodes owned by their Context and
+/// referenced by the CFG, so the columns are kept in addition to them. A
+/// BlockColumns refers to, but does not own, the blocks it was created
+/// from, and does not reflect later changes to the CFG.
+///
+/// \see CFG_GROUP
+class GTIRB_EXPORT_API BlockColumns {
+public:
+  /// \brief The position of a block in the columns.
+  using Index = uint32_t;
+
+  /// \brief Create empty columns.
+  BlockColumns() = default;
+
+  /// \brief Create the columns of the blocks of a CFG.
+  ///
+  /// \param Cfg  The CFG. Blocks at the same address keep their CFG vertex
+  ///             order.
+  explicit BlockColumns(const CFG& Cfg);
+
+  /// \brief Get the number of blocks.
+  size_t size() const { return Addresses.size(); }
+
+  /// \brief Check whether there are no blocks.
+  bool empty() const { return Addresses.empty(); }
+
+  /// \brief The address of each block, in ascending order.
+  gsl::span<const Addr> addresses() const { return Addresses; }
+
+  /// \brief The size of each block, parallel to \ref addresses.
+  gsl::span<const uint64_t> sizes() const { return Sizes; }
+
+  /// \brief The exit kind of each block, parallel to \ref addresses.
+  gsl::span<const Block::Exit> exitKinds() const { return ExitKinds; }
+
+  /// \brief The decode mode of each block, parallel to \ref addresses.
+  gsl::span<const uint64_t> decodeModes() const { return DecodeModes; }
+
+  /// \brief Get the block at an index.
+  ///
+  /// \param I  An index less than \ref size.
+  ///
+  /// \return The block.
+  const Block& block(Index I) const {
+    Expects(I < Blocks.size());
+    return *Blocks[I];
+  }
+
+  /// \brief Get the index of a block.
+  ///
+  /// \param B  The block to look up.
+  ///
+  /// \return The index of \p B, or std::nullopt if \p B is not one of the
+  /// blocks the columns were created from.
+  std::optional<Index> indexOf(const Block& B) const;
+
+  /// \brief Find the blocks starting in a range of addresses.
+  ///
+  /// \param Lower The lower-bounded address to look up.
+  /// \param Upper The upper-bounded address to look up.
+  ///
+  /// \return The indices [first, second) of the blocks whose addresses are
+  /// in [Lower, Upper).
+  std::pair<Index, Index> findBlocks(Addr Lower, Addr Upper) const;
+
+  /// \brief Find the blocks starting in a range of addresses and ending
+  /// with a particular exit kind.
+  ///
+  /// \param Lower The lower-bounded address to look up.
+  /// \param Upper The upper-bounded address to look up.
+  /// \param Kind  The exit kind to look for.
+  ///
+  /// \return The indices of the matching blocks, in ascending order.
+  std::vector<Index> findBlocks(Addr Lower, Addr Upper,
+                                Block::Exit Kind) const;
+
+private:
+  std::vector<Addr> Addresses;
+  std::vector<uint64_t> Sizes;
+  std::vector<Block::Exit> ExitKinds;
+  std::vector<uint64_t> DecodeModes;
+  std::vector<const Block*> Blocks;
+  // The index of the block at each CFG vertex.
+  std::vector<Index> VertexIndices;
+};
+
+} // namespace gtirb
+
+#endif // GTIRB_BLOCK_COLUMNS_H
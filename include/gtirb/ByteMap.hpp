@@ -16,6 +16,7 @@
 #define GTIRB_BYTEMAP_H
 
 #include <gtirb/Addr.hpp>
+#include <gtirb/AddrRange.hpp>
 #include <array>
 #include <boost/range/iterator_range.hpp>
 #include <cstddef>
@@ -24,6 +25,7 @@
 #include <gsl/gsl>
 #include <limits>
 #include <map>
+#include <memory>
 #include <vector>
 
 /// \file ByteMap.hpp
@@ -74,6 +76,12 @@ public:
   /// to this method.
   const_range data(Addr A, size_t Bytes) const;
 
+  /// \brief Get the addresses for which the byte map holds data.
+  ///
+  /// \return The set of addresses, with one range per contiguous region
+  /// of data.
+  AddrRangeSet addressRanges() const { return AddrRangeSet::of(Regions); }
+
   /// \brief The protobuf message type used for serializing ByteMap.
   using MessageType = proto::ByteMap;
 
@@ -95,16 +103,56 @@ public:
   /// \cond INTERNAL
   struct Region {
     Addr Address;
-    std::vector<std::byte> Data;
+    // Copies of a ByteMap share the bytes of each region until one of them
+    // changes it.
+    std::shared_ptr<std::vector<std::byte>> Data =
+        std::make_shared<std::vector<std::byte>>();
 
     Addr getAddress() const { return this->Address; }
 
-    uint64_t getSize() const { return this->Data.size(); }
+    uint64_t getSize() const { return this->Data->size(); }
   };
   /// \endcond
 
 private:
+  // How to undo a call to setData. Regions[Index] is the region which was
+  // changed, or inserted.
+  struct Change {
+    enum class Kind : uint8_t { Overwrite, Append, Prepend, Insert };
+    Kind K;
+    size_t Index;
+    // Overwrite: the offset written at. Append: the region's old size.
+    uint64_t Offset;
+    // The number of bytes written.
+    uint64_t Size;
+    // Append: whether the following region was merged into this one.
+    bool Merged;
+    // Overwrite: the bytes which were overwritten.
+    std::vector<std::byte> Old;
+  };
+
+  // Get the bytes of a region for writing, first copying them if they are
+  // shared with another ByteMap.
+  static std::vector<std::byte>& mutableData(Region& R);
+
+  // Write the data, without tracking the written range.
+  bool writeData(Addr A, gsl::span<const std::byte> Data);
+
+  // Undo the changes recorded after the first N.
+  void undoChanges(size_t N);
+
   std::vector<Region> Regions;
+
+  // While Recording, setData records how to undo each change it makes.
+  bool Recording{false};
+  std::vector<Change> Changes;
+
+  // While Tracking, the ranges written by setData or undoChanges.
+  bool Tracking{false};
+  std::vector<AddrRange> Written;
+
+  // Allow Module to undo changes, and to report them to its observers.
+  friend class Module;
 };
 } // namespace gtirb
 
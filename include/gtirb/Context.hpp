@@ -18,8 +18,13 @@
 #include <gtirb/Allocator.hpp>
 #include <gtirb/Export.hpp>
 #include <boost/uuid/uuid.hpp>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <map>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 /// \file Context.hpp
 /// \brief Class \ref gtirb::Context and related operators.
@@ -39,7 +44,9 @@ class DataObject;
 class ImageByteMap;
 class IR;
 class Module;
+class RegistrationTimer;
 class Section;
+class StatsSink;
 class Symbol;
 
 /// \class Context
@@ -61,6 +68,15 @@ class GTIRB_EXPORT_API Context {
   // will access the UuidMap during their destructors to unregister nodes.
   std::map<UUID, Node*> UuidMap;
 
+  // Pool of interned strings, such as Symbol names. Elements of an
+  // unordered_set are never relocated, so references into the pool remain
+  // valid for the lifetime of the Context.
+  std::unordered_set<std::string> StringPool;
+  // Strings interned in Contexts absorbed by this one which were already in
+  // StringPool. Nodes from those Contexts may still refer to them, so, like
+  // StringPool, these are kept until this Context is destroyed.
+  std::vector<std::unordered_set<std::string>> AbsorbedStringPools;
+
   // Allocate each node type in a separate arena.
   mutable SpecificBumpPtrAllocator<Node> NodeAllocator;
   mutable SpecificBumpPtrAllocator<Block> BlockAllocator;
@@ -71,11 +87,27 @@ class GTIRB_EXPORT_API Context {
   mutable SpecificBumpPtrAllocator<Section> SectionAllocator;
   mutable SpecificBumpPtrAllocator<Symbol> SymbolAllocator;
 
+  // Receives instrumentation of operations in this Context, if not null.
+  StatsSink* Stats = nullptr;
+
+  // While a RegistrationTimer is active, the time spent updating UuidMap
+  // and the number of nodes registered.
+  bool TimingRegistration = false;
+  std::chrono::nanoseconds RegistrationTime{0};
+  uint64_t Registrations = 0;
+
   /// \copybrief gtirb::Node
   friend class Node;
+  friend class RegistrationTimer;
 
-  void registerNode(const UUID& ID, Node* N) { UuidMap[ID] = N; }
+  void registerNode(const UUID& ID, Node* N) {
+    if (TimingRegistration)
+      timedRegisterNode(ID, N);
+    else
+      UuidMap[ID] = N;
+  }
 
+  void timedRegisterNode(const UUID& ID, Node* N);
   void unregisterNode(const Node* N);
   const Node* findNode(const UUID& ID) const;
   Node* findNode(const UUID& ID);
@@ -116,6 +148,70 @@ public:
   NodeTy* Create(Args&&... TheArgs) {
     return new (Allocate<NodeTy>()) NodeTy(std::forward<Args>(TheArgs)...);
   }
+
+  /// \brief Intern a string in this Context's string pool.
+  ///
+  /// \param S  The string to intern.
+  ///
+  /// Interned strings are never released before the Context is destroyed,
+  /// even once no node refers to them: the pool grows with every distinct
+  /// name a Symbol is given, including names later replaced by a rename.
+  /// This is deliberate, as it keeps every reference handed out valid for
+  /// as long as the nodes that may hold it. Contexts that see many
+  /// short-lived names should be discarded rather than reused.
+  ///
+  /// \return A reference to the pooled copy of \p S. Equal strings interned
+  /// in the same Context share a single copy, which remains valid until the
+  /// Context is destroyed.
+  const std::string& internString(const std::string& S) {
+    return *StringPool.insert(S).first;
+  }
+
+  /// \brief Move all the nodes of another Context into this one.
+  ///
+  /// The nodes keep their UUIDs and addresses, so pointers to them remain
+  /// valid, but they are now held in, and destroyed with, this Context. No
+  /// node is copied: the memory holding them changes owner, and their UUIDs
+  /// are spliced into this Context's UUID map. In particular, the contents
+  /// of ImageByteMaps are not copied.
+  ///
+  /// This allows IR to be built in several Contexts, e.g. on several
+  /// threads, and then combined without serializing it:
+  ///
+  /// \code
+  ///   Context Main, Worker;
+  ///   IR* Result = IR::Create(Main);
+  ///   IR* Part = IR::Create(Worker);
+  ///   // ... build Part in Worker ...
+  ///   Main.absorb(Worker);
+  ///   Result->merge(*Part);
+  /// \endcode
+  ///
+  /// Strings interned in \p Other move with its nodes and, like this
+  /// Context's own, are kept until this Context is destroyed.
+  ///
+  /// \param Other  The Context to empty. It may be destroyed afterwards, or
+  ///               reused.
+  ///
+  /// \return \c true on success. Returns \c false, and changes neither
+  /// Context, if a node in \p Other has the same UUID as a node in this
+  /// Context.
+  bool absorb(Context& Other);
+
+  /// \brief Install a sink for instrumentation of operations in this
+  /// Context, such as IR::save and IR::load.
+  ///
+  /// \param Sink  The sink, or null to disable instrumentation. It is not
+  ///              owned by the Context and must outlive its use.
+  ///
+  /// \return void
+  ///
+  /// \see StatsSink
+  void setStatsSink(StatsSink* Sink) { Stats = Sink; }
+
+  /// \brief Get the installed instrumentation sink, or null if there is
+  /// none.
+  StatsSink* getStatsSink() const { return Stats; }
 };
 
 template <> GTIRB_EXPORT_API void* Context::Allocate<Node>() const;
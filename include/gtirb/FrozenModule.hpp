@@ -0,0 +1,424 @@
+//===- FrozenModule.hpp -----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_FROZEN_MODULE_H
+#define GTIRB_FROZEN_MODULE_H
+
+#include <gtirb/Addr.hpp>
+#include <gtirb/BlockColumns.hpp>
+#include <gtirb/ByteMap.hpp>
+#include <gtirb/CFG.hpp>
+#include <gtirb/DataObject.hpp>
+#include <gtirb/Export.hpp>
+#include <gtirb/Section.hpp>
+#include <gtirb/SymbolicExpression.hpp>
+#include <boost/iterator/indirect_iterator.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <gsl/gsl>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// \file FrozenModule.hpp
+/// \brief Class gtirb::FrozenModule.
+
+namespace gtirb {
+class Block;
+class Module;
+class Symbol;
+
+/// \class FrozenModule
+///
+/// \brief An immutable snapshot of the contents of a \ref Module.
+///
+/// A FrozenModule is created by \ref Module::freeze. Its symbols, data
+/// objects, sections and symbolic expressions are held in sorted arrays and
+/// its \ref CFG in compressed sparse row form, sharing the module's \ref
+/// BlockColumns for the attributes of its blocks, so lookups are binary
+/// searches and scans read contiguous memory. It also shares the bytes of
+/// the module's ImageByteMap, so \ref findContents can report everything at
+/// an address in one call.
+///
+/// Every member function is const and no lookup modifies the snapshot, so
+/// any number of threads may query a FrozenModule concurrently without
+/// synchronization. The snapshot refers to, but does not own, the nodes of
+/// the Module it was created from. Later changes to the Module are not
+/// reflected in the snapshot, which must not outlive the Context holding
+/// those nodes.
+class GTIRB_EXPORT_API FrozenModule {
+  struct SymbolNameEntry {
+    std::string_view Name;
+    const Symbol* Sym;
+  };
+
+  struct SymbolAddrEntry {
+    Addr Address;
+    const Symbol* Sym;
+  };
+
+  // One segment of the data address map: the objects in
+  // DataSegmentObjects[Begin, End) all contain [Lower, Upper).
+  struct DataSegment {
+    Addr Lower;
+    Addr Upper;
+    size_t Begin;
+    size_t End;
+  };
+
+  // One segment of the addresses covered by a list of sections or blocks:
+  // the item at Index is the one starting last among those containing each
+  // address in [Lower, Upper).
+  struct ContainingSegment {
+    Addr Lower;
+    Addr Upper;
+    size_t Index;
+  };
+
+  template <typename Entry> struct SymbolEntryTransform {
+    const Symbol& operator()(const Entry& E) const { return *E.Sym; }
+  };
+
+  struct BlockIndexTransform {
+    const Block* const* Blocks;
+    const Block& operator()(uint32_t I) const { return *Blocks[I]; }
+  };
+
+  explicit FrozenModule(const Module& M);
+
+public:
+  /// \name Symbol-Related Public Types and Functions
+  /// @{
+
+  /// \brief Iterator over symbols (\ref Symbol), ordered by name.
+  using symbol_iterator = boost::transform_iterator<
+      SymbolEntryTransform<SymbolNameEntry>,
+      std::vector<SymbolNameEntry>::const_iterator>;
+  /// \brief Range of symbols (\ref Symbol), ordered by name.
+  using symbol_range = boost::iterator_range<symbol_iterator>;
+
+  /// \brief Iterator over symbols (\ref Symbol), ordered by address.
+  using symbol_addr_iterator = boost::transform_iterator<
+      SymbolEntryTransform<SymbolAddrEntry>,
+      std::vector<SymbolAddrEntry>::const_iterator>;
+  /// \brief Range of symbols (\ref Symbol), ordered by address.
+  using symbol_addr_range = boost::iterator_range<symbol_addr_iterator>;
+
+  /// \brief Return a range of all the symbols, ordered by name.
+  symbol_range symbols() const;
+
+  /// \brief Find symbols by name.
+  ///
+  /// \param N The name to look up.
+  ///
+  /// \return A possibly empty range of all the symbols with the given name.
+  symbol_range findSymbols(std::string_view N) const;
+
+  /// \brief Find symbols whose names begin with a prefix.
+  ///
+  /// \param Prefix The name prefix to look up.
+  ///
+  /// \return A possibly empty range of all the symbols whose names begin
+  /// with \p Prefix, ordered by name.
+  symbol_range findSymbolsByPrefix(std::string_view Prefix) const;
+
+  /// \brief Find symbols by address.
+  ///
+  /// \param X The address to look up.
+  ///
+  /// \return A possibly empty range of all the symbols at the given address.
+  symbol_addr_range findSymbols(Addr X) const;
+
+  /// \brief Find symbols by a range of addresses.
+  ///
+  /// \param Lower The lower-bounded address to look up.
+  /// \param Upper The upper-bounded address to look up.
+  ///
+  /// \return A possibly empty range of all the symbols within the given
+  /// address range. Searches the range [Lower, Upper).
+  symbol_addr_range findSymbols(Addr Lower, Addr Upper) const;
+  /// @}
+
+  /// \name DataObject-Related Public Types and Functions
+  /// @{
+
+  /// \brief Iterator over data objects (\ref DataObject).
+  using data_object_iterator = boost::indirect_iterator<
+      std::vector<const DataObject*>::const_iterator>;
+  /// \brief Range of data objects (\ref DataObject).
+  using data_object_range = boost::iterator_range<data_object_iterator>;
+
+  /// \brief Return a range of all the data objects, ordered by address.
+  data_object_range data() const;
+
+  /// \brief Find the data objects containing an address.
+  ///
+  /// \param X The address to look up.
+  ///
+  /// \return A possibly empty range of all the data objects containing \p X.
+  data_object_range findData(Addr X) const;
+  /// @}
+
+  /// \name Section-Related Public Types and Functions
+  /// @{
+
+  /// \brief Iterator over sections (\ref Section).
+  using section_iterator =
+      boost::indirect_iterator<std::vector<const Section*>::const_iterator>;
+  /// \brief Range of sections (\ref Section).
+  using section_range = boost::iterator_range<section_iterator>;
+
+  /// \brief Return a range of all the sections, ordered by address.
+  section_range sections() const;
+
+  /// \brief Find a Section by address.
+  ///
+  /// \param X The address to look up.
+  ///
+  /// \return The section starting at \p X, or null if there is none.
+  const Section* findSection(Addr X) const;
+  /// @}
+
+  /// \name SymbolicExpression-Related Public Types and Functions
+  /// @{
+
+  /// \brief Return the addresses of all symbolic expressions
+  /// (\ref SymbolicExpression), in ascending order.
+  ///
+  /// The result is parallel to \ref symbolicExpressions().
+  gsl::span<const Addr> symbolicExpressionAddrs() const {
+    return SymbolicExprAddrs;
+  }
+
+  /// \brief Return all symbolic expressions (\ref SymbolicExpression),
+  /// ordered by address.
+  gsl::span<const SymbolicExpression> symbolicExpressions() const {
+    return SymbolicExprs;
+  }
+
+  /// \brief Find symbolic expressions by a range of addresses.
+  ///
+  /// \param Lower The lower-bounded address to look up.
+  /// \param Upper The upper-bounded address to look up.
+  ///
+  /// \return A possibly empty span of the symbolic expressions within the
+  /// given address range, ordered by address. Searches the range
+  /// [Lower, Upper).
+  gsl::span<const SymbolicExpression> findSymbolicExpression(Addr Lower,
+                                                             Addr Upper) const;
+
+  /// \brief Find the symbolic expression at an address.
+  ///
+  /// \param X The address to look up.
+  ///
+  /// \return The symbolic expression at \p X, or null if there is none.
+  const SymbolicExpression* findSymbolicExpression(Addr X) const;
+  /// @}
+
+  /// \name CFG-Related Public Types and Functions
+  /// @{
+
+  /// \brief Iterator over blocks (\ref Block).
+  using block_iterator =
+      boost::indirect_iterator<std::vector<const Block*>::const_iterator>;
+  /// \brief Range of blocks (\ref Block).
+  using block_range = boost::iterator_range<block_iterator>;
+
+  /// \brief Iterator over the neighbors of a block (\ref Block) in the CFG.
+  using adjacent_block_iterator =
+      boost::transform_iterator<BlockIndexTransform,
+                                std::vector<uint32_t>::const_iterator>;
+  /// \brief Range of the neighbors of a block (\ref Block) in the CFG.
+  using adjacent_block_range = boost::iterator_range<adjacent_block_iterator>;
+
+  /// \brief Return a range of all the blocks, in CFG vertex order.
+  block_range blocks() const;
+
+  /// \brief Return the successors of a block.
+  ///
+  /// \param B A block in the CFG of the frozen module.
+  ///
+  /// \return The targets of all edges leaving \p B. The result is parallel
+  /// to \ref successorLabels.
+  adjacent_block_range successors(const Block& B) const;
+
+  /// \brief Return the labels of the edges leaving a block.
+  ///
+  /// \param B A block in the CFG of the frozen module.
+  ///
+  /// \return The labels of all edges leaving \p B. The result is parallel to
+  /// \ref successors.
+  gsl::span<const EdgeLabel> successorLabels(const Block& B) const;
+
+  /// \brief Return the predecessors of a block.
+  ///
+  /// \param B A block in the CFG of the frozen module.
+  ///
+  /// \return The sources of all edges entering \p B. The result is parallel
+  /// to \ref predecessorLabels.
+  adjacent_block_range predecessors(const Block& B) const;
+
+  /// \brief Return the labels of the edges entering a block.
+  ///
+  /// \param B A block in the CFG of the frozen module.
+  ///
+  /// \return The labels of all edges entering \p B. The result is parallel
+  /// to \ref predecessors.
+  gsl::span<const EdgeLabel> predecessorLabels(const Block& B) const;
+
+  /// \brief Return the attributes of all the blocks as parallel arrays,
+  /// ordered by address, for scans. These are the \ref
+  /// Module::blockColumns of the module when it was frozen.
+  const BlockColumns& blockColumns() const { return *Columns; }
+  /// @}
+
+  /// \name Address Queries
+  /// @{
+
+  /// \brief Everything at one address, as found by \ref findContents.
+  struct AddrContents {
+    /// \brief The section containing the address, or null. If several do,
+    /// the one starting last.
+    const Section* Sec = nullptr;
+    /// \brief The block containing the address, or null. If several do,
+    /// the one starting last.
+    const Block* Blk = nullptr;
+    /// \brief The data objects containing the address.
+    data_object_range Data;
+    /// \brief The symbols at the address.
+    symbol_addr_range Symbols;
+    /// \brief The symbolic expression at the address, or null.
+    const SymbolicExpression* SymbolicExpr = nullptr;
+    /// \brief The bytes from the address to the end of the contiguous
+    /// region of the ImageByteMap holding it; empty if it holds no byte at
+    /// the address.
+    gsl::span<const std::byte> Bytes;
+  };
+
+  /// \brief Everything starting in a range of addresses, as found by
+  /// \ref findContents.
+  struct AddrRangeContents {
+    /// \brief The sections starting in the range.
+    section_range Sections;
+    /// \brief The indices [first, second) in \ref blockColumns of the blocks
+    /// starting in the range.
+    std::pair<BlockColumns::Index, BlockColumns::Index> Blocks;
+    /// \brief The data objects starting in the range, ordered by address.
+    data_object_range Data;
+    /// \brief The symbols in the range.
+    symbol_addr_range Symbols;
+    /// \brief The symbolic expressions in the range, ordered by address.
+    gsl::span<const SymbolicExpression> SymbolicExprs;
+    /// \brief The bytes in the range; empty unless one contiguous region of
+    /// the ImageByteMap holds all of them.
+    gsl::span<const std::byte> Bytes;
+  };
+
+  /// \brief Find everything at an address.
+  ///
+  /// Costs one binary search of each kind of content, instead of one call
+  /// to each of findSection, findData, findSymbols, findSymbolicExpression
+  /// and ImageByteMap::data, each on a different structure.
+  ///
+  /// \param X The address to look up.
+  ///
+  /// \return The contents at \p X.
+  AddrContents findContents(Addr X) const;
+
+  /// \brief Find everything starting in a range of addresses.
+  ///
+  /// Use findContents(Addr) for what starts before the range but extends
+  /// into it.
+  ///
+  /// \param Lower The lower-bounded address to look up.
+  /// \param Upper The upper-bounded address to look up.
+  ///
+  /// \return The contents in [Lower, Upper).
+  AddrRangeContents findContents(Addr Lower, Addr Upper) const;
+
+  /// \brief Find everything at each of a sorted array of addresses.
+  ///
+  /// Each search starts where the search for the previous address ended,
+  /// so looking up k addresses costs O(k log(n / k)) rather than
+  /// O(k log n), and reads each array forwards.
+  ///
+  /// \param Addrs The addresses to look up, in ascending order.
+  ///
+  /// \return The contents at each address, parallel to \p Addrs.
+  std::vector<AddrContents> findContents(gsl::span<const Addr> Addrs) const;
+  /// @}
+
+private:
+  // Where the search for the previous address of a batched query ended, in
+  // each array.
+  struct ContentsCursor {
+    size_t SectionSegment = 0;
+    size_t BlockSegment = 0;
+    size_t DataSegment = 0;
+    size_t Symbol = 0;
+    size_t SymbolicExpr = 0;
+    size_t Region = 0;
+  };
+
+  AddrContents findContents(Addr X, ContentsCursor& C) const;
+
+  // Sorted by name, then by insertion into the source Module.
+  std::vector<SymbolNameEntry> SymbolsByName;
+  // Sorted by address; symbols without an address are omitted.
+  std::vector<SymbolAddrEntry> SymbolsByAddr;
+
+  std::vector<const DataObject*> Data;
+  std::vector<DataSegment> DataSegments;
+  std::vector<const DataObject*> DataSegmentObjects;
+
+  std::vector<const Section*> Sections;
+  // Sorted by address; Index is a position in Sections.
+  std::vector<ContainingSegment> SectionSegments;
+
+  std::vector<Addr> SymbolicExprAddrs;
+  std::vector<SymbolicExpression> SymbolicExprs;
+
+  // The CFG in compressed sparse row form. The edges leaving Blocks[I] are
+  // SuccTargets[SuccOffsets[I], SuccOffsets[I + 1]), and likewise for the
+  // edges entering it.
+  std::vector<const Block*> Blocks;
+  std::vector<uint32_t> SuccOffsets;
+  std::vector<uint32_t> SuccTargets;
+  std::vector<EdgeLabel> SuccLabels;
+  std::vector<uint32_t> PredOffsets;
+  std::vector<uint32_t> PredSources;
+  std::vector<EdgeLabel> PredLabels;
+
+  // Shared with the Module, until it changes its CFG.
+  std::shared_ptr<const BlockColumns> Columns;
+  // Sorted by address; Index is a position in Columns.
+  std::vector<ContainingSegment> BlockSegments;
+
+  // The regions of the ImageByteMap, sharing their bytes with it until it
+  // changes them.
+  std::vector<ByteMap::Region> ByteRegions;
+
+  adjacent_block_range adjacent(const std::vector<uint32_t>& Offsets,
+                                const std::vector<uint32_t>& Indices,
+                                const Block& B) const;
+
+  friend class Module; // Allow Module to construct snapshots.
+};
+
+} // namespace gtirb
+
+#endif // GTIRB_FROZEN_MODULE_H
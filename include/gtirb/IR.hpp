@@ -18,11 +18,15 @@
 #include <gtirb/Addr.hpp>
 #include <gtirb/AuxData.hpp>
 #include <gtirb/Module.hpp>
+#include <gtirb/ModuleObserver.hpp>
 #include <gtirb/Node.hpp>
 #include <boost/iterator/indirect_iterator.hpp>
 #include <boost/range/iterator_range.hpp>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 /// \file IR.hpp
@@ -34,6 +38,7 @@ namespace proto {
 class IR;
 }
 namespace gtirb {
+class AuxDataTypeRegistry;
 class Module;
 
 /// \class IR
@@ -165,7 +170,11 @@ public:
   /// \param M The Module object to add.
   ///
   /// \return void
-  void addModule(Module* M) { Modules.push_back(M); }
+  void addModule(Module* M) {
+    Modules.push_back(M);
+    if (!SymbolIndex.empty())
+      indexModuleSymbols(*M);
+  }
 
   /// \brief Adds one or more modules to the IR.
   ///
@@ -173,11 +182,76 @@ public:
   ///
   /// \return void
   void addModule(std::initializer_list<Module*> Ms) {
-    Modules.insert(Modules.end(), Ms);
+    for (Module* M : Ms)
+      addModule(M);
   }
 
+  /// \brief Move the modules and AuxData of another IR into this one.
+  ///
+  /// The modules of \p Other are appended to those of this IR, in order.
+  /// Each AuxData table of \p Other is moved unless this IR already has a
+  /// table of the same name, in which case it stays in \p Other.
+  ///
+  /// Both IRs must be held in the same Context. To merge IR built in
+  /// another Context, first move its nodes with Context::absorb.
+  ///
+  /// \param Other The IR to take modules and AuxData from.
+  ///
+  /// \return void
+  void merge(IR& Other);
+
+  /// \name Global Symbol Index
+  /// @{
+
+  /// \brief Constant range of the symbols with one name, across modules.
+  using const_global_symbol_range = boost::iterator_range<
+      boost::indirect_iterator<std::vector<const Symbol*>::const_iterator>>;
+
+  /// \brief Find the Normal, Static and Extern symbols with a name, in all
+  /// modules.
+  ///
+  /// The symbols are listed in module order. The lookup is one hash table
+  /// probe, whatever the number of modules. The index it uses is built by
+  /// the first lookup, and updated as modules are added to this IR. Once it
+  /// is built, each module has a \ref ModuleObserver which updates the index
+  /// when Module::notifyObservers delivers the symbols added to, changed in
+  /// or removed from that module, including by \ref Module::ownSymbol and
+  /// transaction rollback. Changes not yet delivered, and changes which
+  /// modules do not report, such as Symbol::setStorageKind, are not
+  /// reflected until then, or until \ref indexSymbols is called.
+  ///
+  /// The symbols are found read-only; change them through the module
+  /// holding them, e.g. with \ref renameSymbol. A symbol shared by several
+  /// modules of this IR, such as a module and its \ref Module::clone
+  /// "clone", is listed once for each.
+  ///
+  /// Updating the index is not synchronized: do not notify the observers
+  /// of this IR's modules concurrently with each other or with lookups.
+  ///
+  /// \param Name The name to look for.
+  ///
+  /// \return The symbols, possibly none.
+  const_global_symbol_range findGlobalSymbols(const std::string& Name) const;
+
+  /// \brief Build the index used by \ref findGlobalSymbols from the current
+  /// symbols of every module, indexing modules concurrently, and observe
+  /// the modules to keep it up to date.
+  ///
+  /// Lookups build the index if needed, which is not safe to do from
+  /// several threads at once. Call this first to make concurrent lookups
+  /// safe.
+  ///
+  /// \return void
+  void indexSymbols() const;
+  /// @}
+
   /// \brief Serialize to an output stream in binary format.
   ///
+  /// Modules and AuxData tables are encoded concurrently, each into a
+  /// buffer of its own, and the buffers written in order. The result is the
+  /// deterministic serialization of the \ref MessageType "protobuf message"
+  /// for this IR.
+  ///
   /// \param Out The output stream.
   ///
   /// \return void
@@ -224,6 +298,16 @@ public:
   /// \return The deserialized IR object, or null on failure.
   static IR* fromProtobuf(Context& C, const MessageType& Message);
 
+  /// \brief Construct a IR from a protobuf message, taking the serialized
+  /// contents of its \ref AuxData tables instead of copying them.
+  ///
+  /// \param C   The Context in which the deserialized IR will be held.
+  /// \param Message  The protobuf message from which to deserialize. Its
+  ///                 AuxData tables are left empty.
+  ///
+  /// \return The deserialized IR object, or null on failure.
+  static IR* fromProtobuf(Context& C, MessageType&& Message);
+
   /// \name AuxData Properties
   /// @{
 
@@ -312,6 +396,58 @@ public:
   /// \ingroup AUXDATA_GROUP
   void clearAuxData() { AuxDatas.clear(); }
 
+  /// \brief Decode several \ref AuxData tables concurrently.
+  ///
+  /// Serialized tables are decoded by the first call to AuxData::get, one
+  /// table at a time. A tool about to use several large tables can decode
+  /// them up front, in parallel, instead:
+  ///
+  /// \code
+  ///   IR->decodeAuxData<FunctionEntries, Comments>("functionEntries",
+  ///                                                "comments");
+  /// \endcode
+  ///
+  /// Each table is decoded as if by \c getAuxData(Name)->get<T>(). Tables
+  /// which are missing, already decoded or named more than once are
+  /// decoded at most once. No other thread may access the tables of this IR
+  /// during the call.
+  ///
+  /// \tparam Ts  The expected type of each table, in the order of \p Names.
+  ///
+  /// \param Names  The names of the tables to decode.
+  ///
+  /// \return \c true if every table exists and contains its expected type,
+  /// otherwise \c false.
+  ///
+  /// \ingroup AUXDATA_GROUP
+  template <typename... Ts, typename... NameTs>
+  bool decodeAuxData(const NameTs&... Names) {
+    static_assert(sizeof...(Ts) == sizeof...(NameTs),
+                  "decodeAuxData needs one type per table name");
+    std::vector<AuxDataDecodeTask> Tasks;
+    Tasks.reserve(sizeof...(Ts));
+    (Tasks.push_back({getAuxData(Names), [](AuxData& A) {
+                        return A.get<Ts>() != nullptr;
+                      }}),
+     ...);
+    return runAuxDataDecodeTasks(Tasks);
+  }
+
+  /// \brief Decode every \ref AuxData table whose type is registered,
+  /// concurrently.
+  ///
+  /// Like the other overload, but the type of each table is found by its
+  /// serialized type name in \p Registry. No other thread may access the
+  /// tables of this IR during the call.
+  ///
+  /// \param Registry  The types to decode tables as.
+  ///
+  /// \return \c true if the type of every table is registered, otherwise
+  /// \c false. Tables of unregistered types are left as they are.
+  ///
+  /// \ingroup AUXDATA_GROUP
+  bool decodeAuxData(const AuxDataTypeRegistry& Registry);
+
   /// @}
 
   /// \cond INTERNAL
@@ -319,8 +455,61 @@ public:
   /// \endcond
 
 private:
+  struct AuxDataDecodeTask {
+    AuxData* Table;
+    bool (*Decode)(AuxData&);
+  };
+
+  bool runAuxDataDecodeTasks(const std::vector<AuxDataDecodeTask>& Tasks);
+
+  // The global symbol index is split into shards by name hash, so that
+  // shards can be built concurrently. It is empty until first built. Names
+  // are the symbols' own strings, interned in the Context, so indexing a
+  // symbol does not copy its name.
+  struct SymbolIndexEntry {
+    // The symbols with one name, in module order, and the position in
+    // Modules of the module holding each.
+    std::vector<const Symbol*> Symbols;
+    std::vector<size_t> Positions;
+  };
+  using SymbolIndexShard =
+      std::unordered_map<std::string_view, SymbolIndexEntry>;
+  static constexpr size_t SymbolIndexShards = 64;
+  static size_t symbolIndexShard(std::string_view Name) {
+    return std::hash<std::string_view>{}(Name) % SymbolIndexShards;
+  }
+
+  // Keeps the index up to date with the symbols of one module. Each module
+  // of an indexed IR has one, owned by the IR.
+  class SymbolIndexObserver : public ModuleObserver {
+  public:
+    explicit SymbolIndexObserver(size_t P) : Position(P) {}
+    void changed(const Module& M,
+                 gsl::span<const ModuleChange> Changes) override;
+
+    // Index a symbol of the module under its current name, if it is global.
+    void insert(const Symbol* S);
+    // Remove a symbol of the module from the index, if it is indexed. The
+    // same symbol may also be indexed for another module sharing it.
+    void erase(const Symbol* S);
+
+    // The shards of the owning IR, which stay in place if the IR is moved.
+    SymbolIndexShard* Shards = nullptr;
+    // The position of the module in the owning IR's Modules.
+    size_t Position;
+    // The name under which each indexed symbol of the module is indexed.
+    std::unordered_map<const Symbol*, std::string_view> Names;
+  };
+
+  void indexModuleSymbols(Module& M) const;
+
   AuxDataSet AuxDatas;
   std::vector<Module*> Modules;
+  mutable std::vector<SymbolIndexShard> SymbolIndex;
+  // Parallel to Modules once the index is built. A Module and the IR
+  // holding it are destroyed with their Context, so these are never
+  // removed from the modules except by merge.
+  mutable std::vector<std::unique_ptr<SymbolIndexObserver>> IndexObservers;
 
   friend class Context;
 };
@@ -98,6 +98,14 @@ public:
   /// addresses.
   std::pair<Addr, Addr> getAddrMinMax() const { return EaMinMax; }
 
+  /// \brief Get the addresses for which data has been set.
+  ///
+  /// \return The set of addresses, with one range per contiguous region
+  /// of data.
+  ///
+  /// \sa ByteMap::addressRanges()
+  AddrRangeSet addressRanges() const { return BMap.addressRanges(); }
+
   /// \brief Set the byte order to use when getting or setting data.
   ///
   /// \param Value The byte order to use.
@@ -325,6 +333,7 @@ private:
   boost::endian::order ByteOrder{boost::endian::order::native};
 
   friend class Context;
+  friend class Module; // Allow Module to clone its ImageByteMap.
 };
 
 /// \relates ImageByteMap
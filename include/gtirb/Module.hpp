@@ -16,10 +16,13 @@
 #define GTIRB_MODULE_H
 
 #include <gtirb/Addr.hpp>
+#include <gtirb/Block.hpp>
+#include <gtirb/BlockColumns.hpp>
 #include <gtirb/CFG.hpp>
 #include <gtirb/DataObject.hpp>
 #include <gtirb/Export.hpp>
 #include <gtirb/ImageByteMap.hpp>
+#include <gtirb/ModuleObserver.hpp>
 #include <gtirb/Node.hpp>
 #include <gtirb/Section.hpp>
 #include <gtirb/Symbol.hpp>
@@ -38,13 +41,19 @@
 #include <boost/range/iterator_range.hpp>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
 
 /// \file Module.hpp
 /// \brief Class gtirb::Module and related functions and types.
 
 namespace gtirb {
+class FrozenModule;
+
 /// \enum FileFormat
 ///
 /// \brief Identifies an exectuable file format.
@@ -84,20 +93,71 @@ enum class ISAID : uint8_t {
 /// \brief Represents a single binary (library or executable).
 class GTIRB_EXPORT_API Module : public Node {
   struct by_name {};
+  struct by_hashed_name {};
   struct by_address {};
+  struct by_referent {};
+
+  // An element of the SymbolSet. The symbol's address and referent are cached
+  // alongside it so the by_address and by_referent indices compare stored
+  // keys instead of resolving each symbol's payload. Functions which change a
+  // symbol's payload must update the cached keys through SymbolSet::modify.
+  struct SymbolEntry {
+    using element_type = Symbol;
+
+    Symbol* Sym;
+    std::optional<Addr> Address;
+    const Node* Referent;
+
+    Symbol& operator*() const { return *Sym; }
+  };
+
+  static SymbolEntry makeSymbolEntry(Symbol* S) {
+    const Node* Referent = S->getReferent<Block>();
+    if (!Referent)
+      Referent = S->getReferent<DataObject>();
+    return {S, S->getAddress(), Referent};
+  }
 
+  // The ordered by_name index provides sorted iteration, lookup by name in
+  // insertion order, and prefix queries. The by_hashed_name index answers
+  // in constant time whether any symbol has a name, so that looking up an
+  // absent name skips the ordered search.
   using SymbolSet = boost::multi_index::multi_index_container<
-      Symbol*, boost::multi_index::indexed_by<
-                   boost::multi_index::hashed_unique<
-                       boost::multi_index::identity<Symbol*>>,
-                   boost::multi_index::ordered_non_unique<
-                       boost::multi_index::tag<by_name>,
-                       boost::multi_index::const_mem_fun<
-                           Symbol, const std::string&, &Symbol::getName>>,
-                   boost::multi_index::ordered_non_unique<
-                       boost::multi_index::tag<by_address>,
-                       boost::multi_index::const_mem_fun<
-                           Symbol, std::optional<Addr>, &Symbol::getAddress>>>>;
+      SymbolEntry,
+      boost::multi_index::indexed_by<
+          boost::multi_index::hashed_unique<boost::multi_index::member<
+              SymbolEntry, Symbol*, &SymbolEntry::Sym>>,
+          boost::multi_index::ordered_non_unique<
+              boost::multi_index::tag<by_name>,
+              boost::multi_index::const_mem_fun<Symbol, const std::string&,
+                                                &Symbol::getName>>,
+          boost::multi_index::hashed_non_unique<
+              boost::multi_index::tag<by_hashed_name>,
+              boost::multi_index::const_mem_fun<Symbol, const std::string&,
+                                                &Symbol::getName>>,
+          boost::multi_index::ordered_non_unique<
+              boost::multi_index::tag<by_address>,
+              boost::multi_index::member<SymbolEntry, std::optional<Addr>,
+                                         &SymbolEntry::Address>>,
+          boost::multi_index::hashed_non_unique<
+              boost::multi_index::tag<by_referent>,
+              boost::multi_index::member<SymbolEntry, const Node*,
+                                         &SymbolEntry::Referent>>>>;
+
+  // Compatible comparison for the by_name index: a name compares equal to a
+  // SymbolNamePrefix when the name begins with the prefix. Names sharing a
+  // prefix are contiguous in the index, so equal_range finds all of them.
+  struct SymbolNamePrefix {
+    const std::string& Value;
+  };
+  struct SymbolNamePrefixComparator {
+    bool operator()(const std::string& Name, const SymbolNamePrefix& P) const {
+      return Name.compare(0, P.Value.size(), P.Value) < 0;
+    }
+    bool operator()(const SymbolNamePrefix& P, const std::string& Name) const {
+      return Name.compare(0, P.Value.size(), P.Value) > 0;
+    }
+  };
 
   using SymbolicExpressionElement = std::pair<Addr, SymbolicExpression>;
 
@@ -139,6 +199,31 @@ class GTIRB_EXPORT_API Module : public Node {
 
   Module(Context& C);
 
+  // Maps each Symbol to the addresses of the symbolic expressions which refer
+  // to it.
+  using SymbolReferenceMap = std::unordered_multimap<const Symbol*, Addr>;
+
+  // A container which a Module shares with its clones until one of them
+  // changes it. Readers dereference it; writers call mut(), which first
+  // copies the container if another module still refers to it. shared()
+  // skips the copy, for changes which every module referring to the
+  // container must see.
+  template <typename T> class CopyOnWrite {
+  public:
+    const T& operator*() const { return *Ptr; }
+    const T* operator->() const { return Ptr.get(); }
+
+    T& mut() {
+      if (Ptr.use_count() > 1)
+        Ptr = std::make_shared<T>(*Ptr);
+      return *Ptr;
+    }
+    T& shared() { return *Ptr; }
+
+  private:
+    std::shared_ptr<T> Ptr = std::make_shared<T>();
+  };
+
   template <typename Iter> struct SymSetTransform {
     using ParamTy = decltype((*std::declval<Iter>()));
     using RetTy = decltype((*std::declval<ParamTy>().second));
@@ -165,6 +250,9 @@ public:
   /// \return The newly created object.
   static Module* Create(Context& C) { return C.Create<Module>(C); }
 
+  /// \brief Cleans up resources no longer needed by the Module object.
+  ~Module() noexcept;
+
   /// \brief Set the location of the corresponding binary on disk.
   ///
   /// This is for informational purposes only and will not be used to open
@@ -280,20 +368,20 @@ public:
 
   /// \brief Return an iterator to the first Symbol.
   symbol_iterator symbol_begin() {
-    return symbol_iterator(Symbols.get<by_name>().begin());
+    return symbol_iterator(Symbols->get<by_name>().begin());
   }
   /// \brief Return a constant iterator to the first Symbol.
   const_symbol_iterator symbol_begin() const {
-    return const_symbol_iterator(Symbols.get<by_name>().begin());
+    return const_symbol_iterator(Symbols->get<by_name>().begin());
   }
   /// \brief Return an iterator to the element following the last Symbol.
   symbol_iterator symbol_end() {
-    return symbol_iterator(Symbols.get<by_name>().end());
+    return symbol_iterator(Symbols->get<by_name>().end());
   }
   /// \brief Return a constant iterator to the element following the last
   /// Symbol.
   const_symbol_iterator symbol_end() const {
-    return const_symbol_iterator(Symbols.get<by_name>().end());
+    return const_symbol_iterator(Symbols->get<by_name>().end());
   }
   /// \brief Return a range of the symbols (\ref Symbol).
   symbol_range symbols() {
@@ -317,11 +405,77 @@ public:
   ///
   /// \return void
   void addSymbol(std::initializer_list<Symbol*> Ss) {
+    SymbolSet& Syms = Symbols.mut();
     for (auto* S : Ss) {
-      Symbols.insert(S);
+      if (Syms.insert(makeSymbolEntry(S)).second)
+        record(AddedSymbol{S});
     }
   }
 
+  /// \brief Add a range of symbols to the module.
+  ///
+  /// Symbols are sorted by address once and then inserted in order, which is
+  /// considerably faster than adding them one at a time when constructing
+  /// large modules.
+  ///
+  /// \tparam InputIt An input iterator whose value type is Symbol*.
+  ///
+  /// \param Begin The first Symbol to add.
+  /// \param End   The element following the last Symbol to add.
+  ///
+  /// \return void
+  template <typename InputIt> void addSymbol(InputIt Begin, InputIt End) {
+    std::vector<SymbolEntry> Entries;
+    for (; Begin != End; ++Begin)
+      Entries.push_back(makeSymbolEntry(*Begin));
+    if (Entries.empty())
+      return;
+    std::stable_sort(Entries.begin(), Entries.end(),
+                     [](const SymbolEntry& LHS, const SymbolEntry& RHS) {
+                       return LHS.Address < RHS.Address;
+                     });
+
+    SymbolSet& Syms = Symbols.mut();
+    size_t NewSize = Syms.size() + Entries.size();
+    Syms.reserve(NewSize);
+    Syms.get<by_hashed_name>().reserve(NewSize);
+    Syms.get<by_referent>().reserve(NewSize);
+    // Each insertion lands immediately before the hint, so sorted input is
+    // inserted in amortized constant time into the by_address index. Symbols
+    // already present at the same address are skipped over so that new
+    // symbols follow them, as they would with addSymbol(Symbol*).
+    auto& ByAddress = Syms.get<by_address>();
+    auto Hint = ByAddress.upper_bound(Entries.front().Address);
+    for (const auto& E : Entries) {
+      while (Hint != ByAddress.end() && Hint->Address == E.Address)
+        ++Hint;
+      size_t OldSize = Syms.size();
+      Hint = std::next(ByAddress.insert(Hint, E));
+      if (Syms.size() != OldSize)
+        record(AddedSymbol{E.Sym});
+    }
+  }
+
+  /// \brief Make a symbol private to this module.
+  ///
+  /// A module shares its symbols with its \ref clone "clones", so changing
+  /// a shared symbol, e.g. with \ref renameSymbol, changes it in every
+  /// module holding it. To change it in this module only, call ownSymbol
+  /// first and change the symbol it returns. If \p S is shared, it is
+  /// replaced in this module by a copy with a new UUID, and this module's
+  /// symbolic expressions are updated to refer to the copy; \p S itself
+  /// remains in the other modules, but no longer in this one.
+  ///
+  /// \code
+  ///   Module* Trial = M->clone();
+  ///   renameSymbol(*Trial, Trial->ownSymbol(S), "trial_name");
+  /// \endcode
+  ///
+  /// \param S A symbol in this module.
+  ///
+  /// \return \p S if no other module holds it, and its copy otherwise.
+  Symbol& ownSymbol(Symbol& S);
+
   /// \brief Find symbols by name
   ///
   /// \param N The name to look up.
@@ -329,7 +483,7 @@ public:
   /// \return A possibly empty range of all the symbols with the
   /// given name.
   symbol_range findSymbols(const std::string& N) {
-    auto Found = Symbols.get<by_name>().equal_range(N);
+    auto Found = findSymbolsByName(N);
     return boost::make_iterator_range(symbol_iterator(Found.first),
                                       symbol_iterator(Found.second));
   }
@@ -341,7 +495,33 @@ public:
   /// \return A possibly empty constant range of all the symbols with the
   /// given name.
   const_symbol_range findSymbols(const std::string& N) const {
-    auto Found = Symbols.get<by_name>().equal_range(N);
+    auto Found = findSymbolsByName(N);
+    return boost::make_iterator_range(const_symbol_iterator(Found.first),
+                                      const_symbol_iterator(Found.second));
+  }
+
+  /// \brief Find symbols whose names begin with a prefix.
+  ///
+  /// \param Prefix The name prefix to look up.
+  ///
+  /// \return A possibly empty range of all the symbols whose names begin
+  /// with \p Prefix, ordered by name.
+  symbol_range findSymbolsByPrefix(const std::string& Prefix) {
+    auto Found = Symbols->get<by_name>().equal_range(
+        SymbolNamePrefix{Prefix}, SymbolNamePrefixComparator());
+    return boost::make_iterator_range(symbol_iterator(Found.first),
+                                      symbol_iterator(Found.second));
+  }
+
+  /// \brief Find symbols whose names begin with a prefix.
+  ///
+  /// \param Prefix The name prefix to look up.
+  ///
+  /// \return A possibly empty constant range of all the symbols whose names
+  /// begin with \p Prefix, ordered by name.
+  const_symbol_range findSymbolsByPrefix(const std::string& Prefix) const {
+    auto Found = Symbols->get<by_name>().equal_range(
+        SymbolNamePrefix{Prefix}, SymbolNamePrefixComparator());
     return boost::make_iterator_range(const_symbol_iterator(Found.first),
                                       const_symbol_iterator(Found.second));
   }
@@ -353,7 +533,7 @@ public:
   /// \return A possibly empty range of all the symbols containing the given
   /// address.
   symbol_addr_range findSymbols(Addr X) {
-    auto Found = Symbols.get<by_address>().equal_range(X);
+    auto Found = Symbols->get<by_address>().equal_range(X);
     return boost::make_iterator_range(symbol_addr_iterator(Found.first),
                                       symbol_addr_iterator(Found.second));
   }
@@ -365,7 +545,7 @@ public:
   /// \return A possibly empty constant range of all the symbols containing the
   /// given address.
   const_symbol_addr_range findSymbols(Addr X) const {
-    auto Found = Symbols.get<by_address>().equal_range(X);
+    auto Found = Symbols->get<by_address>().equal_range(X);
     return boost::make_iterator_range(const_symbol_addr_iterator(Found.first),
                                       const_symbol_addr_iterator(Found.second));
   }
@@ -379,8 +559,8 @@ public:
   /// address range. Searches the range [Lower, Upper).
   symbol_addr_range findSymbols(Addr Lower, Addr Upper) {
     return boost::make_iterator_range(
-        symbol_addr_iterator(Symbols.get<by_address>().lower_bound(Lower)),
-        symbol_addr_iterator(Symbols.get<by_address>().lower_bound(Upper)));
+        symbol_addr_iterator(Symbols->get<by_address>().lower_bound(Lower)),
+        symbol_addr_iterator(Symbols->get<by_address>().lower_bound(Upper)));
   }
 
   /// \brief Find symbols by a range of addresses.
@@ -393,9 +573,61 @@ public:
   const_symbol_addr_range findSymbols(Addr Lower, Addr Upper) const {
     return boost::make_iterator_range(
         const_symbol_addr_iterator(
-            Symbols.get<by_address>().lower_bound(Lower)),
+            Symbols->get<by_address>().lower_bound(Lower)),
         const_symbol_addr_iterator(
-            Symbols.get<by_address>().lower_bound(Upper)));
+            Symbols->get<by_address>().lower_bound(Upper)));
+  }
+
+  /// \brief Iterator over symbols (\ref Symbol) sharing a referent.
+  using symbol_referent_iterator = boost::indirect_iterator<
+      SymbolSet::index<by_referent>::type::iterator>;
+  /// \brief Range of symbols (\ref Symbol) sharing a referent.
+  using symbol_referent_range = boost::iterator_range<symbol_referent_iterator>;
+  /// \brief Constant iterator over symbols (\ref Symbol) sharing a referent.
+  using const_symbol_referent_iterator = boost::indirect_iterator<
+      SymbolSet::index<by_referent>::type::const_iterator>;
+  /// \brief Constant range of symbols (\ref Symbol) sharing a referent.
+  using const_symbol_referent_range =
+      boost::iterator_range<const_symbol_referent_iterator>;
+
+  /// \brief Find the symbols referring to a Block.
+  ///
+  /// \param B The Block to look up.
+  ///
+  /// \return A possibly empty range of all the symbols whose referent is
+  /// \p B, in no particular order.
+  symbol_referent_range symbolsFor(const Block& B) {
+    return findSymbolsByReferent(&B);
+  }
+
+  /// \brief Find the symbols referring to a Block.
+  ///
+  /// \param B The Block to look up.
+  ///
+  /// \return A possibly empty constant range of all the symbols whose
+  /// referent is \p B, in no particular order.
+  const_symbol_referent_range symbolsFor(const Block& B) const {
+    return findSymbolsByReferent(&B);
+  }
+
+  /// \brief Find the symbols referring to a DataObject.
+  ///
+  /// \param D The DataObject to look up.
+  ///
+  /// \return A possibly empty range of all the symbols whose referent is
+  /// \p D, in no particular order.
+  symbol_referent_range symbolsFor(const DataObject& D) {
+    return findSymbolsByReferent(&D);
+  }
+
+  /// \brief Find the symbols referring to a DataObject.
+  ///
+  /// \param D The DataObject to look up.
+  ///
+  /// \return A possibly empty constant range of all the symbols whose
+  /// referent is \p D, in no particular order.
+  const_symbol_referent_range symbolsFor(const DataObject& D) const {
+    return findSymbolsByReferent(&D);
   }
   /// @}
   // (end group of symbol-related type aliases and functions)
@@ -415,13 +647,49 @@ public:
   /// \brief Get the associated Control Flow Graph (\ref CFG).
   ///
   /// \return The associated CFG.
-  const CFG& getCFG() const { return Cfg; }
+  const CFG& getCFG() const { return *Cfg; }
 
-  /// \brief Get a const reference to the associated Control Flow Graph
+  /// \brief Get a modifiable reference to the associated Control Flow Graph
   /// (\ref CFG).
   ///
+  /// If the CFG is shared with a \ref clone, it is copied first, and the
+  /// module's \ref blockColumns are discarded, so use \ref readCFG to read
+  /// the CFG of a non-const module. Changes made through this reference are
+  /// neither reported to observers nor recorded by transactions; use the
+  /// Module overloads of \ref emplaceBlock, \ref addEdge and \ref
+  /// removeEdge for that.
+  ///
   /// \return The associated CFG.
-  CFG& getCFG() { return Cfg; }
+  CFG& getCFG() {
+    Columns.reset();
+    return Cfg.mut();
+  }
+
+  /// \brief Get the associated Control Flow Graph (\ref CFG) for reading.
+  ///
+  /// Unlike the non-const \ref getCFG, this never copies a CFG shared with
+  /// a \ref clone.
+  ///
+  /// \return The associated CFG.
+  const CFG& readCFG() const { return *Cfg; }
+
+  /// \brief Get the columns of the blocks in the CFG.
+  ///
+  /// The module keeps the address, size, exit kind and decode mode of its
+  /// blocks in parallel arrays sorted by address, in which a block is named
+  /// by its \ref BlockColumns::Index. Scans which read a few attributes of
+  /// many blocks, such as finding the call blocks in an address range, read
+  /// only those arrays rather than the Block nodes.
+  ///
+  /// The columns are built on first use and kept until the CFG may change.
+  /// Calling the non-const \ref getCFG discards them, as does adding or
+  /// removing blocks or edges through the module, and the next call rebuilds
+  /// them. A \ref clone, and a \ref FrozenModule, share them. As they are
+  /// built by a \c const member function, concurrent calls on the same
+  /// module must be synchronized by the caller.
+  ///
+  /// \return The columns, which remain valid until the CFG may change.
+  const BlockColumns& blockColumns() const;
 
   /// \name DataObject-Related Public Types and Functions
   /// @{
@@ -439,18 +707,18 @@ public:
 
   /// \brief Return an iterator to the first DataObject.
   data_object_iterator data_begin() {
-    return data_object_iterator(Data.begin());
+    return data_object_iterator(Data->begin());
   }
   /// \brief Return a constant iterator to the first DataObject.
   const_data_object_iterator data_begin() const {
-    return const_data_object_iterator(Data.begin());
+    return const_data_object_iterator(Data->begin());
   }
   /// \brief Return an iterator to the element following the last DataObject.
-  data_object_iterator data_end() { return data_object_iterator(Data.end()); }
+  data_object_iterator data_end() { return data_object_iterator(Data->end()); }
   /// \brief Return a constant iterator to the element following the last
   /// DataObject.
   const_data_object_iterator data_end() const {
-    return const_data_object_iterator(Data.end());
+    return const_data_object_iterator(Data->end());
   }
   /// \brief Return a range of the data objects (\ref DataObject).
   data_object_range data() {
@@ -474,11 +742,49 @@ public:
   ///
   /// \return void
   void addData(std::initializer_list<DataObject*> Ds) {
-    for (auto* D : Ds)
-      if (Data.emplace(D).second)
-        DataAddrs.add(std::make_pair(DataIntMap::interval_type::right_open(
-                                         D->getAddress(), addressLimit(*D)),
-                                     DataSet{D}));
+    DataSet& Objects = Data.mut();
+    DataIntMap& Addrs = DataAddrs.mut();
+    for (auto* D : Ds) {
+      if (Objects.emplace(D).second) {
+        Addrs.add(std::make_pair(DataIntMap::interval_type::right_open(
+                                     D->getAddress(), addressLimit(*D)),
+                                 DataSet{D}));
+        record(AddedData{D});
+      }
+    }
+  }
+
+  /// \brief Add a range of data objects to the module.
+  ///
+  /// Data objects are sorted by address once and then inserted in order,
+  /// which is considerably faster than adding them one at a time when
+  /// constructing large modules.
+  ///
+  /// \tparam InputIt An input iterator whose value type is DataObject*.
+  ///
+  /// \param Begin The first DataObject to add.
+  /// \param End   The element following the last DataObject to add.
+  ///
+  /// \return void
+  template <typename InputIt> void addData(InputIt Begin, InputIt End) {
+    std::vector<DataObject*> Ds(Begin, End);
+    std::stable_sort(Ds.begin(), Ds.end(),
+                     [](const DataObject* LHS, const DataObject* RHS) {
+                       return LHS->getAddress() < RHS->getAddress();
+                     });
+
+    DataSet& Objects = Data.mut();
+    DataIntMap& Addrs = DataAddrs.mut();
+    auto Hint = Addrs.end();
+    for (auto* D : Ds) {
+      if (Objects.emplace(D).second) {
+        Hint = Addrs.add(
+            Hint, std::make_pair(DataIntMap::interval_type::right_open(
+                                     D->getAddress(), addressLimit(*D)),
+                                 DataSet{D}));
+        record(AddedData{D});
+      }
+    }
   }
 
   /// \brief Find a DataObject by address.
@@ -487,8 +793,8 @@ public:
   ///
   /// \return An iterator to the found object, or \ref data_end() if not found.
   data_object_range findData(Addr X) {
-    auto it = DataAddrs.find(X);
-    if (it == DataAddrs.end())
+    auto it = DataAddrs->find(X);
+    if (it == DataAddrs->end())
       return boost::make_iterator_range(data_object_iterator(),
                                         data_object_iterator());
     return boost::make_iterator_range(data_object_iterator(it->second.begin()),
@@ -501,8 +807,8 @@ public:
   ///
   /// \return An iterator to the found object, or \ref data_end() if not found.
   const_data_object_range findData(Addr X) const {
-    auto it = DataAddrs.find(X);
-    if (it == DataAddrs.end())
+    auto it = DataAddrs->find(X);
+    if (it == DataAddrs->end())
       return boost::make_iterator_range(data_object_iterator(),
                                         data_object_iterator());
     return boost::make_iterator_range(data_object_iterator(it->second.cbegin()),
@@ -516,8 +822,8 @@ public:
 
   /// \brief Iterator over sections (\ref Section).
   using section_iterator =
-      boost::transform_iterator<SymSetTransform<SectionSet::iterator>,
-                                SectionSet::iterator, Section&>;
+      boost::transform_iterator<SymSetTransform<SectionSet::const_iterator>,
+                                SectionSet::const_iterator, Section&>;
   /// \brief Range of sections (\ref Section).
   using section_range = boost::iterator_range<section_iterator>;
   /// \brief Constant iterator over sections (\ref Section).
@@ -529,18 +835,18 @@ public:
 
   /// \brief Return an iterator to the first Section.
   section_iterator section_begin() {
-    return section_iterator(Sections.begin());
+    return section_iterator(Sections->begin());
   }
   /// \brief Return a constant iterator to the first Section.
   const_section_iterator section_begin() const {
-    return const_section_iterator(Sections.begin());
+    return const_section_iterator(Sections->begin());
   }
   /// \brief Return an iterator to the element following the last Section.
-  section_iterator section_end() { return section_iterator(Sections.end()); }
+  section_iterator section_end() { return section_iterator(Sections->end()); }
   /// \brief Return a constant iterator to the element following the last
   /// Section.
   const_section_iterator section_end() const {
-    return const_section_iterator(Sections.end());
+    return const_section_iterator(Sections->end());
   }
   /// \brief Return a range of the sections (\ref Section).
   section_range sections() {
@@ -564,8 +870,40 @@ public:
   ///
   /// \return void
   void addSection(std::initializer_list<Section*> Ss) {
+    SectionSet& Secs = Sections.mut();
     for (auto* S : Ss)
-      Sections.emplace(S->getAddress(), S);
+      if (Secs.emplace(S->getAddress(), S).second)
+        record(AddedSection{S});
+  }
+
+  /// \brief Add a range of section objects to the module.
+  ///
+  /// Sections are sorted by address once and then inserted in order, which
+  /// is considerably faster than adding them one at a time when constructing
+  /// large modules.
+  ///
+  /// \tparam InputIt An input iterator whose value type is Section*.
+  ///
+  /// \param Begin The first Section to add.
+  /// \param End   The element following the last Section to add.
+  ///
+  /// \return void
+  template <typename InputIt> void addSection(InputIt Begin, InputIt End) {
+    std::vector<Section*> Ss(Begin, End);
+    std::stable_sort(Ss.begin(), Ss.end(),
+                     [](const Section* LHS, const Section* RHS) {
+                       return LHS->getAddress() < RHS->getAddress();
+                     });
+
+    SectionSet& Secs = Sections.mut();
+    auto Hint = Ss.empty() ? Secs.end()
+                           : Secs.upper_bound(Ss.front()->getAddress());
+    for (auto* S : Ss) {
+      size_t OldSize = Secs.size();
+      Hint = std::next(Secs.emplace_hint(Hint, S->getAddress(), S));
+      if (Secs.size() != OldSize)
+        record(AddedSection{S});
+    }
   }
 
   /// \brief Find a Section by address.
@@ -575,7 +913,7 @@ public:
   /// \return An iterator to the found object, or \ref section_end() if not
   /// found.
   section_iterator findSection(Addr X) {
-    return section_iterator(Sections.find(X));
+    return section_iterator(Sections->find(X));
   }
 
   /// \brief Find a Section by address.
@@ -585,7 +923,7 @@ public:
   /// \return An iterator to the found object, or \ref section_end() if not
   /// found.
   const_section_iterator findSection(Addr X) const {
-    return const_section_iterator(Sections.find(X));
+    return const_section_iterator(Sections->find(X));
   }
   /// @}
   // (end group of Section-related types and functions)
@@ -611,13 +949,13 @@ public:
   /// \brief Return an iterator to the first \ref SymbolicExpression.
   symbolic_expr_iterator symbolic_expr_begin() {
     return symbolic_expr_iterator(
-        boost::multi_index::get<0>(SymbolicOperands).begin());
+        boost::multi_index::get<0>(*SymbolicOperands).begin());
   }
   /// \brief Return an iterator to the element following the last
   /// \ref SymbolicExpression.
   symbolic_expr_iterator symbolic_expr_end() {
     return symbolic_expr_iterator(
-        boost::multi_index::get<0>(SymbolicOperands).end());
+        boost::multi_index::get<0>(*SymbolicOperands).end());
   }
   /// \brief Return a range of the symbolic expressions
   /// (\ref SymbolicExpression).
@@ -629,13 +967,13 @@ public:
   /// \brief Return a constant iterator to the first \ref SymbolicExpression.
   const_symbolic_expr_iterator symbolic_expr_begin() const {
     return const_symbolic_expr_iterator(
-        boost::multi_index::get<0>(SymbolicOperands).begin());
+        boost::multi_index::get<0>(*SymbolicOperands).begin());
   }
   /// \brief Return a constant iterator to the element following the last
   /// \ref SymbolicExpression.
   const_symbolic_expr_iterator symbolic_expr_end() const {
     return const_symbolic_expr_iterator(
-        boost::multi_index::get<0>(SymbolicOperands).end());
+        boost::multi_index::get<0>(*SymbolicOperands).end());
   }
   /// \brief Return a constant range of the symbolic expressions
   /// (\ref SymbolicExpression).
@@ -653,7 +991,7 @@ public:
   /// end of the iterator range can be obtained by calling symbolic_expr_end().
   symbolic_expr_iterator findSymbolicExpression(Addr X) {
     return symbolic_expr_iterator(
-        SymbolicOperands.find(X, SymbolicExpressionElementAddrComparator{}));
+        SymbolicOperands->find(X, SymbolicExpressionElementAddrComparator{}));
   }
   /// \brief Find symbolic expressions (\ref SymbolicExpression) by
   /// address.
@@ -665,7 +1003,7 @@ public:
   /// symbolic_expr_end().
   const_symbolic_expr_iterator findSymbolicExpression(Addr X) const {
     return const_symbolic_expr_iterator(
-        SymbolicOperands.find(X, SymbolicExpressionElementAddrComparator{}));
+        SymbolicOperands->find(X, SymbolicExpressionElementAddrComparator{}));
   }
 
   /// \brief Find symbolic expressions (\ref SymbolicExpression) by a range of
@@ -679,8 +1017,8 @@ public:
   symbolic_expr_range findSymbolicExpression(Addr Lower, Addr Upper) {
     SymbolicExpressionElementAddrComparator Comp;
     return boost::make_iterator_range(
-        symbolic_expr_iterator(SymbolicOperands.lower_bound(Lower, Comp)),
-        symbolic_expr_iterator(SymbolicOperands.lower_bound(Upper, Comp)));
+        symbolic_expr_iterator(SymbolicOperands->lower_bound(Lower, Comp)),
+        symbolic_expr_iterator(SymbolicOperands->lower_bound(Upper, Comp)));
   }
 
   /// \brief Find symbolic expressions (\ref SymbolicExpression) by a range of
@@ -695,9 +1033,10 @@ public:
                                                    Addr Upper) const {
     SymbolicExpressionElementAddrComparator Comp;
     return boost::make_iterator_range(
-        const_symbolic_expr_iterator(SymbolicOperands.lower_bound(Lower, Comp)),
         const_symbolic_expr_iterator(
-            SymbolicOperands.lower_bound(Upper, Comp)));
+            SymbolicOperands->lower_bound(Lower, Comp)),
+        const_symbolic_expr_iterator(
+            SymbolicOperands->lower_bound(Upper, Comp)));
   }
 
   /// \brief Constant iterator over the address objects used to register a
@@ -722,13 +1061,42 @@ public:
   /// expression (\ref SymbolicExpression) was registered at.
   const_symbolic_expr_addr_range
   getAddrsForSymbolicExpression(const SymbolicExpression& SE) const {
-    const auto& Index = boost::multi_index::get<1>(SymbolicOperands);
+    const auto& Index = boost::multi_index::get<1>(*SymbolicOperands);
     auto R = Index.equal_range(SE);
     return boost::make_iterator_range(
         const_symbolic_expr_addr_iterator(R.first),
         const_symbolic_expr_addr_iterator(R.second));
   }
 
+  /// \brief Constant iterator over addresses of symbolic expressions
+  /// (\ref SymbolicExpression) referring to a Symbol.
+  using const_symbol_reference_addr_iterator = boost::transform_iterator<
+      SymExprSetTransform<SymbolReferenceMap::const_iterator>,
+      SymbolReferenceMap::const_iterator>;
+  /// \brief Constant range of addresses of symbolic expressions
+  /// (\ref SymbolicExpression) referring to a Symbol.
+  using const_symbol_reference_addr_range =
+      boost::iterator_range<const_symbol_reference_addr_iterator>;
+
+  /// \brief Finds the addresses of all symbolic expressions
+  /// (\ref SymbolicExpression) in the module which refer to a Symbol.
+  ///
+  /// Every kind of symbolic expression is considered, and the lookup takes
+  /// time proportional to the number of results rather than to the number of
+  /// symbolic expressions in the module.
+  ///
+  /// \param S The symbol to look up.
+  ///
+  /// \return A possibly empty range of the addresses of symbolic expressions
+  /// referring to \p S, in no particular order.
+  const_symbol_reference_addr_range
+  getSymbolicExpressionAddrs(const Symbol& S) const {
+    auto R = SymbolReferences->equal_range(&S);
+    return boost::make_iterator_range(
+        const_symbol_reference_addr_iterator(R.first),
+        const_symbol_reference_addr_iterator(R.second));
+  }
+
   /// \brief Add a symbolic expression (\ref SymbolicExpression) to
   /// the module.
   ///
@@ -737,11 +1105,148 @@ public:
   ///
   /// \return void
   void addSymbolicExpression(Addr X, const SymbolicExpression& SE) {
-    SymbolicOperands.emplace(X, SE);
+    if (SymbolicOperands.mut().emplace(X, SE).second) {
+      addSymbolReferences(X, SE);
+      record(AddedSymbolicExpression{X});
+    }
+  }
+
+  /// \brief Add a range of symbolic expressions to the module.
+  ///
+  /// Expressions are sorted by address once and then inserted in order,
+  /// which is considerably faster than adding them one at a time when
+  /// constructing large modules. As with \ref addSymbolicExpression(Addr,
+  /// const SymbolicExpression&), an expression at an address which already
+  /// has one is ignored.
+  ///
+  /// \tparam InputIt An input iterator whose value type is convertible to
+  /// std::pair<Addr, SymbolicExpression>.
+  ///
+  /// \param Begin The first address/expression pair to add.
+  /// \param End   The element following the last pair to add.
+  ///
+  /// \return void
+  template <typename InputIt>
+  void addSymbolicExpression(InputIt Begin, InputIt End) {
+    std::vector<SymbolicExpressionElement> Elements(Begin, End);
+    if (Elements.empty())
+      return;
+    std::stable_sort(Elements.begin(), Elements.end(),
+                     SymbolicExpressionElementComparator());
+
+    SymbolicExpressionSet& Operands = SymbolicOperands.mut();
+    SymbolReferenceMap& References = SymbolReferences.mut();
+    Operands.get<1>().reserve(Operands.size() + Elements.size());
+    References.reserve(References.size() + Elements.size());
+    auto Hint = Operands.upper_bound(Elements.front());
+    for (auto& E : Elements) {
+      size_t OldSize = Operands.size();
+      Hint = std::next(Operands.insert(Hint, E));
+      if (Operands.size() != OldSize) {
+        addSymbolReferences(E.first, E.second);
+        record(AddedSymbolicExpression{E.first});
+      }
+    }
   }
   /// @}
   // (end group of SymbolicExpression-related type aliases and methods)
 
+  /// \brief Create an immutable snapshot of this module.
+  ///
+  /// The snapshot may be queried from any number of threads concurrently
+  /// without synchronization. Later changes to this module are not reflected
+  /// in it. It also indexes blocks and overlapping sections by address: use
+  /// FrozenModule::findContents to find everything at an address.
+  ///
+  /// \return A FrozenModule holding the current contents of this module.
+  FrozenModule freeze() const;
+
+  /// \brief Create a copy of this module which shares its contents.
+  ///
+  /// The copy refers to the same blocks, data objects, sections and symbols,
+  /// and shares the containers which index them, the CFG, and the bytes of
+  /// each ImageByteMap region. Either module copies a container or region
+  /// the first time it adds to or removes from it. Only the new module and
+  /// its ImageByteMap get new UUIDs, so cloning costs time proportional to
+  /// the number of ImageByteMap regions, and each such change afterwards
+  /// costs time proportional to the container it changes.
+  ///
+  /// Changing a shared symbol, e.g. with \ref renameSymbol, changes it in
+  /// both modules, and updates the index of each without copying it. To
+  /// change a symbol in one module only, first copy it with \ref
+  /// ownSymbol.
+  ///
+  /// Iterators into a module are invalidated by the first change to the
+  /// corresponding container after cloning. As they share nodes, a module
+  /// and its clone should not be serialized in the same IR.
+  ///
+  /// \return The new Module, held in the same Context as this one and not
+  /// added to any IR.
+  Module* clone() const;
+
+  /// \name Transactions
+  /// @{
+
+  /// \brief Start recording changes to this module, so that they can be
+  /// undone.
+  ///
+  /// While a transaction is open, the module records how to undo each
+  /// addSymbol, addData, addSection and addSymbolicExpression, each change to
+  /// a symbol through \ref renameSymbol, \ref setSymbolAddress, \ref
+  /// setReferent or \ref ownSymbol, each ImageByteMap::setData, and each
+  /// CFG change made with the Module overloads of \ref emplaceBlock, \ref
+  /// addEdge and \ref removeEdge. Other changes, such as changes made
+  /// through \ref getCFG or setting ImageByteMap properties, are not
+  /// recorded.
+  ///
+  /// Transactions nest: committing or rolling back ends the most recently
+  /// begun transaction.
+  void beginTransaction();
+
+  /// \brief End the current transaction, keeping its changes.
+  ///
+  /// If an enclosing transaction is open, rolling it back will still undo
+  /// these changes. Costs time proportional to the number of changes made in
+  /// the outermost transaction.
+  void commitTransaction();
+
+  /// \brief End the current transaction, undoing its changes.
+  ///
+  /// Nodes created during the transaction remain in the Context, but are
+  /// removed from this module. Costs time proportional to the number of
+  /// changes undone.
+  void rollbackTransaction();
+
+  /// \brief Check: is a transaction open?
+  bool inTransaction() const { return !Savepoints.empty(); }
+  /// @}
+
+  /// \name Observers
+  /// @{
+
+  /// \brief Register an observer of changes to this module.
+  ///
+  /// Changes not yet delivered are first delivered to the observers already
+  /// registered, so the new observer receives only later changes.
+  ///
+  /// \param O  The observer. The module does not own it; it must be removed
+  ///           before it is destroyed.
+  void addObserver(ModuleObserver& O);
+
+  /// \brief Unregister an observer. Changes not yet delivered are not
+  /// delivered to it.
+  ///
+  /// \param O  The observer.
+  void removeObserver(ModuleObserver& O);
+
+  /// \brief Deliver the changes made since the last call, as one batch, to
+  /// each registered observer.
+  ///
+  /// Does nothing if there were no changes. Costs time proportional to the
+  /// number of changes, plus the number of observers.
+  void notifyObservers();
+  /// @}
+
   /// \brief The protobuf message type used for serializing Module.
   using MessageType = proto::Module;
 
@@ -764,15 +1269,6 @@ public:
   static bool classof(const Node* N) { return N->getKind() == Kind::Module; }
   /// \endcond
 
-  /// \cond INTERNAL
-  /// Needed by the serialization engine to work with SymbolicExpressionSet,
-  /// which is a type private to Module.
-  friend void addElement(SymbolicExpressionSet& Container,
-                         SymbolicExpressionElement&& Element) {
-    Container.insert(std::move(Element));
-  }
-  /// \endcond
-
 private:
   std::string BinaryPath{};
   Addr PreferredAddr;
@@ -780,15 +1276,154 @@ private:
   gtirb::FileFormat FileFormat{};
   gtirb::ISAID IsaID{};
   std::string Name{};
-  CFG Cfg;
-  DataSet Data;
-  DataIntMap DataAddrs;
+  CopyOnWrite<CFG> Cfg;
+  CopyOnWrite<DataSet> Data;
+  CopyOnWrite<DataIntMap> DataAddrs;
   ImageByteMap* ImageBytes;
-  SectionSet Sections;
-  SymbolSet Symbols;
-  SymbolicExpressionSet SymbolicOperands;
+  CopyOnWrite<SectionSet> Sections;
+  CopyOnWrite<SymbolSet> Symbols;
+  CopyOnWrite<SymbolicExpressionSet> SymbolicOperands;
+  CopyOnWrite<SymbolReferenceMap> SymbolReferences;
+  // The columns of the blocks in Cfg, built by blockColumns.
+  mutable std::shared_ptr<const BlockColumns> Columns;
+
+  // The modules which may share symbols with this one: those it was cloned
+  // from or into, transitively. Null until this module is first cloned.
+  struct SymbolSharers {
+    std::vector<Module*> Modules;
+  };
+  mutable std::shared_ptr<SymbolSharers> Sharers;
 
-  friend class Context; // Allow Context to construct new Modules.
+  // Inverse operations, recorded while a transaction is open.
+  struct AddedSymbol {
+    Symbol* S;
+  };
+  struct ChangedSymbol {
+    Symbol* S;
+    const std::string* Name;
+    std::variant<std::monostate, Addr, Node*> Payload;
+  };
+  struct ReplacedSymbol {
+    Symbol* From;
+    Symbol* To;
+  };
+  struct AddedData {
+    DataObject* D;
+  };
+  struct AddedSection {
+    Section* S;
+  };
+  struct AddedSymbolicExpression {
+    Addr A;
+  };
+  struct AddedBlock {
+    Block* B;
+  };
+  struct AddedEdge {
+    const Block* From;
+    const Block* To;
+  };
+  struct RemovedEdge {
+    const Block* From;
+    const Block* To;
+    EdgeLabel Label;
+  };
+  using Change =
+      std::variant<AddedSymbol, ChangedSymbol, ReplacedSymbol, AddedData,
+                   AddedSection, AddedSymbolicExpression, AddedBlock,
+                   AddedEdge, RemovedEdge>;
+
+  // The state to return to when a transaction is rolled back.
+  struct Savepoint {
+    size_t Changes;
+    size_t ByteChanges;
+  };
+
+  std::vector<Change> UndoLog;
+  std::vector<Savepoint> Savepoints;
+
+  std::vector<ModuleObserver*> Observers;
+  std::vector<ModuleChange> PendingChanges;
+
+  // Record a change for a transaction to undo, and for observers.
+  void record(Change C) {
+    if (!Observers.empty())
+      report(C);
+    if (!Savepoints.empty())
+      UndoLog.push_back(std::move(C));
+  }
+  void report(const Change& C);
+  void report(ModuleChange::Kind What, const Node* Item,
+              const Block* Target = nullptr) {
+    if (!Observers.empty())
+      PendingChanges.push_back({What, Item, Target, Addr(), 0});
+  }
+  void recordSymbol(Symbol& S) { record(ChangedSymbol{&S, S.Name, S.Payload}); }
+
+  // Whether another module holds S.
+  bool sharesSymbol(const Symbol& S) const;
+
+  // Apply a change to S, and update the index of every module holding S.
+  // Containers shared with other modules are changed in place, as S changes
+  // in all of them.
+  template <typename ApplyTy> void changeSymbol(Symbol& S, ApplyTy Apply) {
+    auto& Syms = Symbols.shared();
+    std::vector<std::pair<Module*, SymbolSet*>> Others;
+    if (Sharers)
+      for (Module* Other : Sharers->Modules) {
+        SymbolSet& OtherSyms = Other->Symbols.shared();
+        if (Other != this && OtherSyms.find(&S) != OtherSyms.end())
+          Others.emplace_back(Other, &OtherSyms);
+      }
+    // Remove S from the other containers while their keys are current.
+    std::vector<SymbolSet*> Removed;
+    for (auto& [Other, OtherSyms] : Others)
+      if (OtherSyms != &Syms && OtherSyms->erase(&S) != 0)
+        Removed.push_back(OtherSyms);
+    Syms.modify(Syms.find(&S), [&Apply, &S](SymbolEntry& E) {
+      Apply();
+      E = makeSymbolEntry(&S);
+    });
+    for (SymbolSet* OtherSyms : Removed)
+      OtherSyms->insert(makeSymbolEntry(&S));
+    for (auto& Other : Others)
+      Other.first->report(ModuleChange::Kind::SymbolChanged, &S);
+  }
+  void undo(const Change& C);
+
+  // Replace a symbol in the symbol index and the symbolic expressions.
+  void replaceSymbol(Symbol& From, Symbol& To);
+
+  // Index the symbols referred to by a newly added symbolic expression.
+  void addSymbolReferences(Addr X, const SymbolicExpression& SE);
+  // Remove the references made by a symbolic expression from the index.
+  void removeSymbolReferences(Addr X, const SymbolicExpression& SE);
+
+  // The symbols named N, in the by_name index.
+  std::pair<SymbolSet::index<by_name>::type::const_iterator,
+            SymbolSet::index<by_name>::type::const_iterator>
+  findSymbolsByName(const std::string& N) const {
+    const auto& ByName = Symbols->get<by_name>();
+    if (Symbols->get<by_hashed_name>().find(N) ==
+        Symbols->get<by_hashed_name>().end())
+      return {ByName.end(), ByName.end()};
+    return ByName.equal_range(N);
+  }
+
+  symbol_referent_range findSymbolsByReferent(const Node* N) {
+    auto Found = Symbols->get<by_referent>().equal_range(N);
+    return boost::make_iterator_range(symbol_referent_iterator(Found.first),
+                                      symbol_referent_iterator(Found.second));
+  }
+  const_symbol_referent_range findSymbolsByReferent(const Node* N) const {
+    auto Found = Symbols->get<by_referent>().equal_range(N);
+    return boost::make_iterator_range(
+        const_symbol_referent_iterator(Found.first),
+        const_symbol_referent_iterator(Found.second));
+  }
+
+  friend class Context;      // Allow Context to construct new Modules.
+  friend class FrozenModule; // Allow snapshots to read the indices.
 
   // Allow these methods to update Symbols.
   friend void renameSymbol(Module& M, Symbol& S, const std::string& N);
@@ -796,6 +1431,13 @@ private:
   template <typename NodeTy>
   friend std::enable_if_t<Symbol::is_supported_type<NodeTy>()>
   setReferent(Module& M, Symbol& S, NodeTy* N);
+
+  // Allow these methods to record changes to the CFG.
+  template <class... Ts>
+  friend Block* emplaceBlock(Module& M, Context& C, Ts&&... Args);
+  friend CFG::edge_descriptor addEdge(const Block* From, const Block* To,
+                                      Module& M);
+  friend bool removeEdge(const Block* From, const Block* To, Module& M);
 };
 
 /// \relates Addr
@@ -845,6 +1487,62 @@ Symbol* emplaceSymbol(Module& M, Context& C, Ts&&... Args) {
   return S;
 }
 
+/// \relates Module
+/// \relates Block
+/// \brief Create a new block and add it to the CFG of a module.
+///
+/// Unlike adding it with \ref Module::getCFG, this reports the new block
+/// to the module's observers, and records it to be removed if the current
+/// transaction is rolled back.
+///
+/// \tparam Ts   Types of forwarded arguments.
+///
+/// \param M     The Module to modify.
+/// \param C     The Context in which the Block will be held.
+/// \param Args  Forwarded to Block::Create()
+///
+/// \return A pointer to the newly created Block.
+template <class... Ts>
+Block* emplaceBlock(Module& M, Context& C, Ts&&... Args) {
+  Block* B = emplaceBlock(M.getCFG(), C, std::forward<Ts>(Args)...);
+  M.record(Module::AddedBlock{B});
+  return B;
+}
+
+/// \relates Module
+/// \relates Block
+/// \brief Create a new edge between two blocks in the CFG of a module.
+///
+/// Unlike adding it with \ref Module::getCFG, this reports the new edge
+/// to the module's observers, and records it to be removed if the current
+/// transaction is rolled back.
+///
+/// \param From  The source block.
+/// \param To    The target block.
+/// \param M     The Module to modify.
+///
+/// \return A descriptor which can be used to retrieve the edge from
+/// Module::getCFG or assign a label.
+GTIRB_EXPORT_API CFG::edge_descriptor addEdge(const Block* From,
+                                              const Block* To, Module& M);
+
+/// \relates Module
+/// \relates Block
+/// \brief Remove an edge between two blocks from the CFG of a module.
+///
+/// If there are several edges from \p From to \p To, the most recently
+/// added one is removed. The removal is reported to the module's observers,
+/// and the edge and its label are recorded to be restored if the current
+/// transaction is rolled back.
+///
+/// \param From  The source block.
+/// \param To    The target block.
+/// \param M     The Module to modify.
+///
+/// \return \c true if an edge was removed, \c false if there was none.
+GTIRB_EXPORT_API bool removeEdge(const Block* From, const Block* To,
+                                 Module& M);
+
 /// \relates Module
 /// \relates Symbol
 /// \brief Change the name of a symbol and update the module with the new symbol
@@ -856,8 +1554,12 @@ Symbol* emplaceSymbol(Module& M, Context& C, Ts&&... Args) {
 /// \param M  The module containing the symbol.
 /// \param S  The symbol to rename.
 /// \param N  The new name to assign.
+///
+/// If \p S is shared with a clone of \p M, it is renamed in both; see
+/// Module::ownSymbol.
 inline void renameSymbol(Module& M, Symbol& S, const std::string& N) {
-  M.Symbols.modify(M.Symbols.find(&S), [&N, &S](Symbol*) { S.Name = N; });
+  M.recordSymbol(S);
+  M.changeSymbol(S, [&N, &S] { S.Name = &S.getContext().internString(N); });
 }
 
 /// \relates Module
@@ -874,10 +1576,14 @@ inline void renameSymbol(Module& M, Symbol& S, const std::string& N) {
 /// \param M  The module containing the symbol.
 /// \param S  The symbol to modify.
 /// \param N  The node to reference.
+///
+/// If \p S is shared with a clone of \p M, it is changed in both; see
+/// Module::ownSymbol.
 template <typename NodeTy>
 std::enable_if_t<Symbol::is_supported_type<NodeTy>()>
 setReferent(Module& M, Symbol& S, NodeTy* N) {
-  M.Symbols.modify(M.Symbols.find(&S), [&N, &S](Symbol*) { S.Payload = N; });
+  M.recordSymbol(S);
+  M.changeSymbol(S, [&N, &S] { S.Payload = N; });
 }
 
 /// \brief Deleted overload used to prevent setting a referent of an unsupported
@@ -899,8 +1605,12 @@ setReferent(Module& M, Symbol& S, NodeTy* N) = delete;
 /// \param M  The module containing the symbol.
 /// \param S  The symbol to modify.
 /// \param A  The new address to assign.
+///
+/// If \p S is shared with a clone of \p M, it is changed in both; see
+/// Module::ownSymbol.
 inline void setSymbolAddress(Module& M, Symbol& S, Addr A) {
-  M.Symbols.modify(M.Symbols.find(&S), [&A, &S](Symbol*) { S.Payload = A; });
+  M.recordSymbol(S);
+  M.changeSymbol(S, [&A, &S] { S.Payload = A; });
 }
 } // namespace gtirb
 
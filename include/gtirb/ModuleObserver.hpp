@@ -0,0 +1,123 @@
+//===- ModuleObserver.hpp ---------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_MODULE_OBSERVER_H
+#define GTIRB_MODULE_OBSERVER_H
+
+#include <gtirb/Addr.hpp>
+#include <gtirb/Export.hpp>
+#include <cstdint>
+#include <gsl/gsl>
+
+/// \file ModuleObserver.hpp
+/// \brief Classes gtirb::ModuleChange and gtirb::ModuleObserver.
+
+namespace gtirb {
+class Block;
+class Module;
+class Node;
+
+/// \brief One change to a \ref Module, reported to a \ref ModuleObserver.
+struct ModuleChange {
+  /// \brief What changed.
+  enum class Kind : uint8_t {
+    /// Item is a Symbol added to the module.
+    SymbolAdded,
+    /// Item is a Symbol removed from the module.
+    SymbolRemoved,
+    /// Item is a Symbol whose name, address or referent changed.
+    SymbolChanged,
+    /// Item is a DataObject added to the module.
+    DataAdded,
+    /// Item is a DataObject removed from the module.
+    DataRemoved,
+    /// Item is a Section added to the module.
+    SectionAdded,
+    /// Item is a Section removed from the module.
+    SectionRemoved,
+    /// A symbolic expression was added at Address.
+    SymbolicExpressionAdded,
+    /// The symbolic expression at Address was removed.
+    SymbolicExpressionRemoved,
+    /// Item is a Block added to the CFG.
+    BlockAdded,
+    /// Item is a Block removed from the CFG.
+    BlockRemoved,
+    /// An edge from the Block Item to Target was added to the CFG.
+    EdgeAdded,
+    /// An edge from the Block Item to Target was removed from the CFG.
+    EdgeRemoved,
+    /// The Size bytes at Address in the ImageByteMap were written.
+    BytesChanged,
+  };
+
+  /// \brief What changed.
+  Kind What;
+  /// \brief The node which changed, or the source of an edge.
+  const Node* Item = nullptr;
+  /// \brief The target of an edge.
+  const Block* Target = nullptr;
+  /// \brief The address of a symbolic expression or of changed bytes.
+  Addr Address;
+  /// \brief The number of changed bytes.
+  uint64_t Size = 0;
+};
+
+/// \class ModuleObserver
+///
+/// \brief Receives batches of changes made to a \ref Module, so that caches
+/// derived from it can be updated incrementally.
+///
+/// Register an observer with Module::addObserver. The module collects its
+/// changes, and delivers them as one batch when Module::notifyObservers is
+/// called, typically at the end of each pass:
+///
+/// \code
+///   struct FunctionCache : ModuleObserver {
+///     std::set<const Symbol*> Stale;
+///     void changed(const Module&,
+///                  gsl::span<const ModuleChange> Changes) override {
+///       for (const auto& C : Changes)
+///         if (C.What == ModuleChange::Kind::SymbolChanged)
+///           Stale.insert(cast<Symbol>(C.Item));
+///     }
+///   };
+/// \endcode
+///
+/// Changes made through the Module, including changes to its CFG made with
+/// the Module overloads of emplaceBlock, addEdge and removeEdge, are listed
+/// in the order they were made. Bytes written with ImageByteMap::setData
+/// follow them. Changes which a transaction rolled back are reported as the
+/// inverse changes, e.g. SymbolRemoved for a symbol whose addition was
+/// rolled back.
+///
+/// Only the changes listed in ModuleChange::Kind are reported; e.g.
+/// changing the CFG through Module::getCFG, or changing ImageByteMap
+/// properties, is not. When a module has no observers, reporting costs a
+/// test of an empty vector per change.
+class GTIRB_EXPORT_API ModuleObserver {
+public:
+  virtual ~ModuleObserver() = default;
+
+  /// \brief Receive a batch of changes.
+  ///
+  /// \param M        The module which changed.
+  /// \param Changes  The changes, in order. Never empty.
+  virtual void changed(const Module& M,
+                       gsl::span<const ModuleChange> Changes) = 0;
+};
+
+} // namespace gtirb
+
+#endif // GTIRB_MODULE_OBSERVER_H
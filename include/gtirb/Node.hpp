@@ -84,6 +84,9 @@ public:
 protected:
   /// \cond INTERNAL
   Node(Context& C, Kind Knd);
+
+  /// \brief Get the Context in which this Node is held.
+  Context& getContext() const { return *Ctx; }
   /// \endcond
 
 private:
@@ -0,0 +1,103 @@
+//===- Stats.hpp ------------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_STATS_H
+#define GTIRB_STATS_H
+
+#include <gtirb/Export.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+/// \file Stats.hpp
+/// \brief Classes gtirb::PhaseStats and gtirb::StatsSink.
+
+namespace gtirb {
+
+/// \brief Measurements of one phase of saving or loading IR.
+///
+/// Phases are named "<Operation>/<phase>", e.g. "Module::fromProtobuf/cfg".
+/// The phases reported are:
+///
+/// - "IR::save/serialize" and "IR::load/parse": writing and reading the
+///   protobuf wire format. Bytes is the size of the serialized IR.
+/// - "IR::toProtobuf/modules" and "IR::fromProtobuf/modules": converting all
+///   modules. Nodes is the number of modules.
+/// - "IR::toProtobuf/auxData" and "IR::fromProtobuf/auxData": converting all
+///   AuxData tables. Nodes is the number of tables and Bytes the size of
+///   their encoded data.
+/// - "Module::toProtobuf/<part>" and "Module::fromProtobuf/<part>", once per
+///   module, where part is one of "byteMap", "cfg", "data", "sections",
+///   "symbols" and "symbolicOperands". Loading a module also reports
+///   "Module::fromProtobuf/symbolIndex", the time to index its symbols.
+/// - "CFG::fromProtobuf/blocks" and "CFG::fromProtobuf/edges", once per
+///   module: creating blocks, and resolving edges to their blocks.
+/// - "Context/registerNode", once per IR::fromProtobuf: registering the
+///   UUIDs of the nodes it creates with the \ref Context, accumulated over
+///   all of them. Nodes is the number of registrations, which may exceed
+///   the number of nodes, as a node loaded with its UUID is registered
+///   under a fresh one first.
+///
+/// Phases nest; e.g. the "Module::fromProtobuf/..." phases of a module are
+/// part of "IR::fromProtobuf/modules". The time in "Context/registerNode"
+/// is also part of the phases which create the nodes.
+struct PhaseStats {
+  /// \brief The name of the phase. Refers to a string literal.
+  std::string_view Phase;
+  /// \brief The wall-clock time spent in the phase.
+  std::chrono::nanoseconds Time{0};
+  /// \brief The number of bytes processed, or 0 if not meaningful.
+  uint64_t Bytes = 0;
+  /// \brief The number of nodes or other items processed, or 0 if not
+  /// meaningful.
+  uint64_t Nodes = 0;
+};
+
+/// \class StatsSink
+///
+/// \brief Receives \ref PhaseStats from the operations of a \ref Context.
+///
+/// Install a sink with Context::setStatsSink. Each phase is reported once
+/// it completes, on the thread which started the operation. A phase that
+/// runs once per module is reported for each module, so a sink that wants
+/// totals should sum records with the same name:
+///
+/// \code
+///   struct Totals : StatsSink {
+///     std::map<std::string_view, PhaseStats> ByPhase;
+///     void record(const PhaseStats& S) override {
+///       auto& T = ByPhase[S.Phase];
+///       T.Phase = S.Phase;
+///       T.Time += S.Time;
+///       T.Bytes += S.Bytes;
+///       T.Nodes += S.Nodes;
+///     }
+///   };
+/// \endcode
+///
+/// When no sink is installed, the instrumentation costs a test of a null
+/// pointer per phase.
+class GTIRB_EXPORT_API StatsSink {
+public:
+  virtual ~StatsSink() = default;
+
+  /// \brief Receive the measurements of a completed phase.
+  ///
+  /// \param Stats  The measurements.
+  virtual void record(const PhaseStats& Stats) = 0;
+};
+
+} // namespace gtirb
+
+#endif // GTIRB_STATS_H
@@ -300,7 +300,7 @@ public:
   /// \brief Get the name.
   ///
   /// \return The name.
-  const std::string& getName() const { return Name; }
+  const std::string& getName() const { return *Name; }
 
   /// \brief Get the referent to which this symbol refers.
   ///
@@ -366,22 +366,29 @@ public:
   /// \endcond
 
 private:
-  Symbol(Context& C) : Node(C, Kind::Symbol) {}
+  Symbol(Context& C)
+      : Node(C, Kind::Symbol), Name(&C.internString(std::string())) {}
   Symbol(Context& C, const std::string& N, StorageKind SK = StorageKind::Extern)
-      : Node(C, Kind::Symbol), Payload(), Name(N), Storage(SK) {}
+      : Node(C, Kind::Symbol), Payload(), Name(&C.internString(N)),
+        Storage(SK) {}
   Symbol(Context& C, Addr X, const std::string& N,
          StorageKind SK = StorageKind::Extern)
-      : Node(C, Kind::Symbol), Payload(X), Name(N), Storage(SK) {}
+      : Node(C, Kind::Symbol), Payload(X), Name(&C.internString(N)),
+        Storage(SK) {}
   template <typename NodeTy>
   Symbol(Context& C, NodeTy* R, const std::string& N,
          StorageKind SK = StorageKind::Extern)
-      : Node(C, Kind::Symbol), Payload(R), Name(N), Storage(SK) {}
+      : Node(C, Kind::Symbol), Payload(R), Name(&C.internString(N)),
+        Storage(SK) {}
 
   std::variant<std::monostate, Addr, Node*> Payload;
-  std::string Name;
+  // Interned in the Context's string pool, so that symbols sharing a name
+  // (common for long mangled C++ names) share a single copy of it.
+  const std::string* Name;
   Symbol::StorageKind Storage{StorageKind::Extern};
 
   friend class Context; // Allow Context to construct Symbols.
+  friend class Module;  // Allow Module to copy shared Symbols.
 
   // Allow these methods to update Symbol contents.
   friend void renameSymbol(Module& M, Symbol& S, const std::string& N);
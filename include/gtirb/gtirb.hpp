@@ -22,17 +22,23 @@
 /// \brief Main namespace for the GTIRB API.
 
 #include <gtirb/Addr.hpp>
+#include <gtirb/AddrRange.hpp>
 #include <gtirb/AuxData.hpp>
+#include <gtirb/AuxDataTypeRegistry.hpp>
 #include <gtirb/Block.hpp>
+#include <gtirb/BlockColumns.hpp>
 #include <gtirb/ByteMap.hpp>
 #include <gtirb/CFG.hpp>
 #include <gtirb/DataObject.hpp>
 #include <gtirb/Export.hpp>
+#include <gtirb/FrozenModule.hpp>
 #include <gtirb/IR.hpp>
 #include <gtirb/ImageByteMap.hpp>
 #include <gtirb/Module.hpp>
+#include <gtirb/ModuleObserver.hpp>
 #include <gtirb/Node.hpp>
 #include <gtirb/Section.hpp>
+#include <gtirb/Stats.hpp>
 #include <gtirb/Symbol.hpp>
 #include <gtirb/SymbolicExpression.hpp>
 
@@ -0,0 +1,171 @@
+//===- AddrRange.cpp --------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "AddrRange.hpp"
+
+using namespace gtirb;
+
+AddrRangeSet::AddrRangeSet(std::vector<AddrRange> Unsorted) {
+  if (!std::is_sorted(Unsorted.begin(), Unsorted.end()))
+    std::sort(Unsorted.begin(), Unsorted.end());
+  Ranges.reserve(Unsorted.size());
+  for (AddrRange R : Unsorted)
+    append(R);
+}
+
+void AddrRangeSet::append(AddrRange R) {
+  if (R.empty())
+    return;
+  if (!Ranges.empty() && R.lower() <= Ranges.back().upper()) {
+    if (R.upper() > Ranges.back().upper())
+      Ranges.back() = AddrRange(Ranges.back().lower(), R.upper());
+    return;
+  }
+  Ranges.push_back(R);
+}
+
+uint64_t AddrRangeSet::size() const {
+  uint64_t Size = 0;
+  for (AddrRange R : Ranges)
+    Size += R.size();
+  return Size;
+}
+
+void AddrRangeSet::insert(AddrRange R) {
+  if (R.empty())
+    return;
+  // Replace the ranges overlapping or adjacent to R with their union.
+  auto Begin = std::lower_bound(
+      Ranges.begin(), Ranges.end(), R.lower(),
+      [](AddrRange E, Addr A) { return E.upper() < A; });
+  auto End = std::upper_bound(
+      Begin, Ranges.end(), R.upper(),
+      [](Addr A, AddrRange E) { return A < E.lower(); });
+  if (Begin == End) {
+    Ranges.insert(Begin, R);
+    return;
+  }
+  *Begin = AddrRange(std::min(Begin->lower(), R.lower()),
+                     std::max(std::prev(End)->upper(), R.upper()));
+  Ranges.erase(std::next(Begin), End);
+}
+
+const AddrRange* AddrRangeSet::find(Addr A) const {
+  // Find the first range ending after A.
+  auto It = std::upper_bound(Ranges.begin(), Ranges.end(), A,
+                             [](Addr X, AddrRange E) { return X < E.upper(); });
+  if (It == Ranges.end() || !It->contains(A))
+    return nullptr;
+  return &*It;
+}
+
+bool AddrRangeSet::contains(AddrRange R) const {
+  if (R.empty())
+    return true;
+  const AddrRange* Found = find(R.lower());
+  return Found && Found->contains(R);
+}
+
+bool AddrRangeSet::overlaps(AddrRange R) const {
+  if (R.empty())
+    return false;
+  auto It = std::upper_bound(
+      Ranges.begin(), Ranges.end(), R.lower(),
+      [](Addr X, AddrRange E) { return X < E.upper(); });
+  return It != Ranges.end() && It->overlaps(R);
+}
+
+template <typename Func>
+void AddrRangeSet::forEachContained(gsl::span<const Addr> Addrs,
+                                    Func F) const {
+  if (Ranges.empty())
+    return;
+  if (std::is_sorted(Addrs.begin(), Addrs.end())) {
+    // Merge the addresses with the ranges.
+    auto R = Ranges.begin();
+    for (size_t I = 0; I < static_cast<size_t>(Addrs.size()); ++I) {
+      Addr A = Addrs[I];
+      while (R->upper() <= A)
+        if (++R == Ranges.end())
+          return;
+      if (R->lower() <= A)
+        F(I);
+    }
+  } else {
+    for (size_t I = 0; I < static_cast<size_t>(Addrs.size()); ++I)
+      if (contains(Addrs[I]))
+        F(I);
+  }
+}
+
+std::vector<size_t>
+AddrRangeSet::findContained(gsl::span<const Addr> Addrs) const {
+  std::vector<size_t> Result;
+  forEachContained(Addrs, [&Result](size_t I) { Result.push_back(I); });
+  return Result;
+}
+
+size_t AddrRangeSet::countContained(gsl::span<const Addr> Addrs) const {
+  size_t Count = 0;
+  forEachContained(Addrs, [&Count](size_t) { ++Count; });
+  return Count;
+}
+
+namespace gtirb {
+AddrRangeSet operator|(const AddrRangeSet& LHS, const AddrRangeSet& RHS) {
+  AddrRangeSet Result;
+  Result.Ranges.reserve(LHS.Ranges.size() + RHS.Ranges.size());
+  auto L = LHS.Ranges.begin(), R = RHS.Ranges.begin();
+  while (L != LHS.Ranges.end() || R != RHS.Ranges.end()) {
+    if (R == RHS.Ranges.end() || (L != LHS.Ranges.end() && *L < *R))
+      Result.append(*L++);
+    else
+      Result.append(*R++);
+  }
+  return Result;
+}
+
+AddrRangeSet operator&(const AddrRangeSet& LHS, const AddrRangeSet& RHS) {
+  AddrRangeSet Result;
+  auto L = LHS.Ranges.begin(), R = RHS.Ranges.begin();
+  while (L != LHS.Ranges.end() && R != RHS.Ranges.end()) {
+    Result.append(L->intersection(*R));
+    // Advance whichever range ends first; the other may overlap more.
+    if (L->upper() < R->upper())
+      ++L;
+    else
+      ++R;
+  }
+  return Result;
+}
+
+AddrRangeSet operator-(const AddrRangeSet& LHS, const AddrRangeSet& RHS) {
+  AddrRangeSet Result;
+  auto R = RHS.Ranges.begin();
+  for (AddrRange L : LHS.Ranges) {
+    Addr Lower = L.lower();
+    // Skip the ranges of RHS ending before this range.
+    while (R != RHS.Ranges.end() && R->upper() <= Lower)
+      ++R;
+    // Remove each range of RHS overlapping this one.
+    for (auto It = R; It != RHS.Ranges.end() && It->lower() < L.upper();
+         ++It) {
+      Result.append(AddrRange(Lower, It->lower()));
+      Lower = std::max(Lower, It->upper());
+    }
+    Result.append(AddrRange(Lower, L.upper()));
+  }
+  return Result;
+}
+} // namespace gtirb
@@ -23,8 +23,16 @@
 namespace gtirb {
 void fromProtobuf(Context&, AuxData& Result, const proto::AuxData& Message) {
   Result.Impl = nullptr;
-  Result.TypeName = Message.type_name();
+  Result.setSerializedType(Message.type_name());
   Result.RawBytes = Message.data();
+  Result.RawIndex.reset();
+}
+
+void fromProtobuf(Context&, AuxData& Result, proto::AuxData&& Message) {
+  Result.Impl = nullptr;
+  Result.setSerializedType(Message.type_name());
+  Result.RawBytes = std::move(*Message.mutable_data());
+  Result.RawIndex.reset();
 }
 
 proto::AuxData toProtobuf(const AuxData& T) {
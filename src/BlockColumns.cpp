@@ -0,0 +1,75 @@
+//===- BlockColumns.cpp -----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "BlockColumns.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+using namespace gtirb;
+
+BlockColumns::BlockColumns(const CFG& Cfg) {
+  size_t NumBlocks = num_vertices(Cfg);
+  Expects(NumBlocks <= std::numeric_limits<Index>::max());
+
+  // Sort the vertices by address, then fill each column in that order.
+  std::vector<CFG::vertex_descriptor> Order(NumBlocks);
+  std::iota(Order.begin(), Order.end(), CFG::vertex_descriptor(0));
+  std::stable_sort(Order.begin(), Order.end(),
+                   [&Cfg](CFG::vertex_descriptor L, CFG::vertex_descriptor R) {
+                     return Cfg[L]->getAddress() < Cfg[R]->getAddress();
+                   });
+
+  Addresses.reserve(NumBlocks);
+  Sizes.reserve(NumBlocks);
+  ExitKinds.reserve(NumBlocks);
+  DecodeModes.reserve(NumBlocks);
+  Blocks.reserve(NumBlocks);
+  VertexIndices.resize(NumBlocks);
+  for (auto V : Order) {
+    const Block* B = Cfg[V];
+    VertexIndices[V] = static_cast<Index>(Blocks.size());
+    Addresses.push_back(B->getAddress());
+    Sizes.push_back(B->getSize());
+    ExitKinds.push_back(B->getExitKind());
+    DecodeModes.push_back(B->getDecodeMode());
+    Blocks.push_back(B);
+  }
+}
+
+std::optional<BlockColumns::Index>
+BlockColumns::indexOf(const Block& B) const {
+  size_t V = B.getVertex();
+  if (V >= VertexIndices.size() || Blocks[VertexIndices[V]] != &B)
+    return std::nullopt;
+  return VertexIndices[V];
+}
+
+std::pair<BlockColumns::Index, BlockColumns::Index>
+BlockColumns::findBlocks(Addr Lower, Addr Upper) const {
+  auto Begin = std::lower_bound(Addresses.begin(), Addresses.end(), Lower);
+  auto End = std::lower_bound(Begin, Addresses.end(), Upper);
+  return {static_cast<Index>(Begin - Addresses.begin()),
+          static_cast<Index>(End - Addresses.begin())};
+}
+
+std::vector<BlockColumns::Index>
+BlockColumns::findBlocks(Addr Lower, Addr Upper, Block::Exit Kind) const {
+  auto [Begin, End] = findBlocks(Lower, Upper);
+  std::vector<Index> Result;
+  for (Index I = Begin; I < End; ++I)
+    if (ExitKinds[I] == Kind)
+      Result.push_back(I);
+  return Result;
+}
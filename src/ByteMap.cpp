@@ -55,7 +55,21 @@ bool ByteMap::willOverlapRegion(Addr A, size_t Bytes) const {
   return false;
 }
 
+std::vector<std::byte>& ByteMap::mutableData(Region& R) {
+  if (R.Data.use_count() > 1)
+    R.Data = std::make_shared<std::vector<std::byte>>(*R.Data);
+  return *R.Data;
+}
+
 bool ByteMap::setData(Addr A, gsl::span<const std::byte> Data) {
+  if (!writeData(A, Data))
+    return false;
+  if (Tracking)
+    Written.emplace_back(A, A + uint64_t(Data.size_bytes()));
+  return true;
+}
+
+bool ByteMap::writeData(Addr A, gsl::span<const std::byte> Data) {
   // Look for a region to hold this data. If necessary, extend or merge
   // existing regions to keep allocations contiguous.
   Addr Limit = A + uint64_t(Data.size_bytes());
@@ -64,8 +78,13 @@ bool ByteMap::setData(Addr A, gsl::span<const std::byte> Data) {
 
     // Overwrite data in existing region
     if (containsAddr(Current, A) && Limit <= addressLimit(Current)) {
-      auto Offset = A - Current.Address;
-      std::copy(Data.begin(), Data.end(), Current.Data.begin() + Offset);
+      auto Offset = static_cast<uint64_t>(A - Current.Address);
+      auto Begin = mutableData(Current).begin() + Offset;
+      if (Recording)
+        Changes.push_back({Change::Kind::Overwrite, i, Offset, Data.size(),
+                           false, std::vector<std::byte>(
+                                      Begin, Begin + Data.size())});
+      std::copy(Data.begin(), Data.end(), Begin);
       return true;
     }
 
@@ -76,13 +95,18 @@ bool ByteMap::setData(Addr A, gsl::span<const std::byte> Data) {
         return false;
       }
 
-      Current.Data.reserve(Current.Data.size() + Data.size());
-      std::copy(Data.begin(), Data.end(), std::back_inserter(Current.Data));
+      auto& Bytes = mutableData(Current);
+      bool Merge = HasNext && Limit == Regions[i + 1].Address;
+      if (Recording)
+        Changes.push_back({Change::Kind::Append, i, Bytes.size(),
+                           Data.size(), Merge, {}});
+      Bytes.reserve(Bytes.size() + Data.size());
+      std::copy(Data.begin(), Data.end(), std::back_inserter(Bytes));
       // Merge with subsequent region
-      if (HasNext && Limit == Regions[i + 1].Address) {
-        const auto& D = Regions[i + 1].Data;
-        Current.Data.reserve(Current.Data.size() + D.size());
-        std::copy(D.begin(), D.end(), std::back_inserter(Current.Data));
+      if (Merge) {
+        const auto& D = *Regions[i + 1].Data;
+        Bytes.reserve(Bytes.size() + D.size());
+        std::copy(D.begin(), D.end(), std::back_inserter(Bytes));
         this->Regions.erase(this->Regions.begin() + i + 1);
       }
       return true;
@@ -92,8 +116,11 @@ bool ByteMap::setData(Addr A, gsl::span<const std::byte> Data) {
     if (Limit == Current.Address) {
       // Note: this is probably O(N^2), moving existing data on each inserted
       // element.
-      std::copy(Data.begin(), Data.end(),
-                std::inserter(Current.Data, Current.Data.begin()));
+      auto& Bytes = mutableData(Current);
+      if (Recording)
+        Changes.push_back(
+            {Change::Kind::Prepend, i, 0, Data.size(), false, {}});
+      std::copy(Data.begin(), Data.end(), std::inserter(Bytes, Bytes.begin()));
       Current.Address = A;
       return true;
     }
@@ -104,19 +131,62 @@ bool ByteMap::setData(Addr A, gsl::span<const std::byte> Data) {
   }
 
   // Not contiguous with any existing data. Create a new region.
-  Region R = {A, std::vector<std::byte>()};
-  R.Data.reserve(Data.size());
-  std::copy(Data.begin(), Data.end(), std::back_inserter(R.Data));
-  this->Regions.insert(
+  Region R{A};
+  R.Data->reserve(Data.size());
+  std::copy(Data.begin(), Data.end(), std::back_inserter(*R.Data));
+  auto Pos = this->Regions.insert(
       std::lower_bound(this->Regions.begin(), this->Regions.end(), R,
                        [](const auto& Left, const auto& Right) {
                          return Left.Address < Right.Address;
                        }),
       std::move(R));
+  if (Recording)
+    Changes.push_back({Change::Kind::Insert,
+                       static_cast<size_t>(Pos - this->Regions.begin()), 0,
+                       Data.size(), false, {}});
 
   return true;
 }
 
+void ByteMap::undoChanges(size_t N) {
+  for (; Changes.size() > N; Changes.pop_back()) {
+    const Change& C = Changes.back();
+    Region& Current = Regions[C.Index];
+    if (Tracking) {
+      Addr Start = C.K == Change::Kind::Overwrite || C.K == Change::Kind::Append
+                       ? Current.Address + C.Offset
+                       : Current.Address;
+      Written.emplace_back(Start, Start + C.Size);
+    }
+    switch (C.K) {
+    case Change::Kind::Overwrite:
+      std::copy(C.Old.begin(), C.Old.end(),
+                mutableData(Current).begin() + C.Offset);
+      break;
+    case Change::Kind::Append: {
+      auto& Bytes = mutableData(Current);
+      if (C.Merged) {
+        // Split the merged region off again.
+        Region Next{Current.Address + (C.Offset + C.Size)};
+        Next.Data->assign(Bytes.begin() + C.Offset + C.Size, Bytes.end());
+        Regions.insert(Regions.begin() + C.Index + 1, std::move(Next));
+      }
+      Bytes.resize(C.Offset);
+      break;
+    }
+    case Change::Kind::Prepend: {
+      auto& Bytes = mutableData(Current);
+      Bytes.erase(Bytes.begin(), Bytes.begin() + C.Size);
+      Current.Address += C.Size;
+      break;
+    }
+    case Change::Kind::Insert:
+      Regions.erase(Regions.begin() + C.Index);
+      break;
+    }
+  }
+}
+
 ByteMap::const_range ByteMap::data(Addr A, size_t Bytes) const {
   auto Reg = std::find_if(this->Regions.begin(), this->Regions.end(),
                           [A](const auto& R) { return containsAddr(R, A); });
@@ -126,7 +196,7 @@ ByteMap::const_range ByteMap::data(Addr A, size_t Bytes) const {
     return ByteMap::const_range{};
   }
 
-  auto Begin = Reg->Data.begin() + (A - Reg->Address);
+  auto Begin = Reg->Data->cbegin() + (A - Reg->Address);
   return {Begin, Begin + Bytes};
 }
 
@@ -134,7 +204,7 @@ namespace gtirb {
 proto::Region toProtobuf(const ByteMap::Region& R) {
   proto::Region Message;
   Message.set_address(static_cast<uint64_t>(R.Address));
-  std::transform(R.Data.begin(), R.Data.end(),
+  std::transform(R.Data->begin(), R.Data->end(),
                  std::back_inserter(*Message.mutable_data()),
                  [](auto x) { return char(x); });
   return Message;
@@ -144,8 +214,8 @@ void fromProtobuf(Context&, ByteMap::Region& Val,
                   const proto::Region& Message) {
   Val.Address = Addr(Message.address());
   const auto& Data = Message.data();
-  Val.Data.reserve(Data.size());
-  std::transform(Data.begin(), Data.end(), std::back_inserter(Val.Data),
+  Val.Data->reserve(Data.size());
+  std::transform(Data.begin(), Data.end(), std::back_inserter(*Val.Data),
                  [](auto x) { return std::byte(x); });
 }
 } // namespace gtirb
@@ -13,6 +13,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include "CFG.hpp"
+#include "PhaseTimer.hpp"
 #include "Serialization.hpp"
 #include <gtirb/Block.hpp>
 #include <proto/CFG.pb.h>
@@ -65,13 +66,19 @@ proto::CFG toProtobuf(const CFG& Cfg) {
 }
 
 void fromProtobuf(Context& C, CFG& Result, const proto::CFG& Message) {
-  std::for_each(Message.blocks().begin(), Message.blocks().end(),
-                [&Result, &C](const auto& M) {
-                  auto* B =
-                      emplaceBlock(Result, C, Addr(M.address()), M.size(),
-                                   Block::Exit(M.exit_kind()), M.decode_mode());
-                  setNodeUUIDFromBytes(B, M.uuid());
-                });
+  {
+    PhaseTimer Timer(C, "CFG::fromProtobuf/blocks");
+    Timer.setNodes(Message.blocks_size());
+    std::for_each(Message.blocks().begin(), Message.blocks().end(),
+                  [&Result, &C](const auto& M) {
+                    auto* B = emplaceBlock(Result, C, Addr(M.address()),
+                                           M.size(), Block::Exit(M.exit_kind()),
+                                           M.decode_mode());
+                    setNodeUUIDFromBytes(B, M.uuid());
+                  });
+  }
+  PhaseTimer Timer(C, "CFG::fromProtobuf/edges");
+  Timer.setNodes(Message.edges_size());
   std::for_each(Message.edges().begin(), Message.edges().end(),
                 [&Result, &C](const auto& M) {
                   auto* Source = dyn_cast_or_null<Block>(
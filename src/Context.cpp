@@ -21,6 +21,7 @@
 #include <gtirb/Node.hpp>
 #include <gtirb/Section.hpp>
 #include <gtirb/Symbol.hpp>
+#include <iterator>
 
 using namespace gtirb;
 
@@ -30,7 +31,61 @@ using namespace gtirb;
 Context::Context() = default;
 Context::~Context() = default;
 
-void Context::unregisterNode(const Node* N) { UuidMap.erase(N->getUUID()); }
+void Context::timedRegisterNode(const UUID& ID, Node* N) {
+  auto Start = std::chrono::steady_clock::now();
+  UuidMap[ID] = N;
+  RegistrationTime += std::chrono::steady_clock::now() - Start;
+  ++Registrations;
+}
+
+void Context::unregisterNode(const Node* N) {
+  if (!TimingRegistration) {
+    UuidMap.erase(N->getUUID());
+    return;
+  }
+  auto Start = std::chrono::steady_clock::now();
+  UuidMap.erase(N->getUUID());
+  RegistrationTime += std::chrono::steady_clock::now() - Start;
+}
+
+bool Context::absorb(Context& Other) {
+  if (&Other == this)
+    return true;
+
+  // Both maps are sorted, so one pass over them finds any shared UUID.
+  auto It = UuidMap.begin();
+  for (const auto& Entry : Other.UuidMap) {
+    while (It != UuidMap.end() && It->first < Entry.first)
+      ++It;
+    if (It != UuidMap.end() && It->first == Entry.first)
+      return false;
+  }
+
+  for (auto& Entry : Other.UuidMap)
+    Entry.second->Ctx = this;
+  UuidMap.merge(Other.UuidMap);
+
+  // Merging moves each string's node, so references to it stay valid. The
+  // strings left behind are duplicates which must outlive their nodes.
+  StringPool.merge(Other.StringPool);
+  if (!Other.StringPool.empty())
+    AbsorbedStringPools.push_back(std::move(Other.StringPool));
+  Other.StringPool.clear();
+  std::move(Other.AbsorbedStringPools.begin(),
+            Other.AbsorbedStringPools.end(),
+            std::back_inserter(AbsorbedStringPools));
+  Other.AbsorbedStringPools.clear();
+
+  NodeAllocator.absorb(Other.NodeAllocator);
+  BlockAllocator.absorb(Other.BlockAllocator);
+  DataObjectAllocator.absorb(Other.DataObjectAllocator);
+  ImageByteMapAllocator.absorb(Other.ImageByteMapAllocator);
+  IrAllocator.absorb(Other.IrAllocator);
+  ModuleAllocator.absorb(Other.ModuleAllocator);
+  SectionAllocator.absorb(Other.SectionAllocator);
+  SymbolAllocator.absorb(Other.SymbolAllocator);
+  return true;
+}
 
 const Node* Context::findNode(const UUID& ID) const {
   auto Iter = UuidMap.find(ID);
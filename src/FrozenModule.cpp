@@ -0,0 +1,439 @@
+//===- FrozenModule.cpp -----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "FrozenModule.hpp"
+#include <gtirb/Block.hpp>
+#include <gtirb/DataObject.hpp>
+#include <gtirb/Module.hpp>
+#include <gtirb/Section.hpp>
+#include <gtirb/Symbol.hpp>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <tuple>
+
+using namespace gtirb;
+
+// Compatible comparison for SymbolsByName: a name compares equal to a
+// NamePrefix when the name begins with the prefix.
+namespace {
+struct NamePrefix {
+  std::string_view Value;
+};
+
+int comparePrefix(std::string_view Name, NamePrefix P) {
+  return Name.substr(0, P.Value.size()).compare(P.Value);
+}
+
+// The first element of the sorted range [From, End) for which IsBefore is
+// false. Searches exponentially outwards from From, then by bisection, so
+// the cost is logarithmic in the distance moved rather than in the size of
+// the range.
+template <typename It, typename Pred>
+It gallop(It From, It End, Pred IsBefore) {
+  size_t Step = 1;
+  while (Step <= static_cast<size_t>(End - From) && IsBefore(From[Step - 1])) {
+    From += Step;
+    Step *= 2;
+  }
+  It Limit = From + std::min(Step, static_cast<size_t>(End - From));
+  return std::partition_point(From, Limit, IsBefore);
+}
+
+// Divide the addresses covered by N items, ordered by address, into
+// segments in which the same item is the one starting last among those
+// containing each address, and pass each segment to Emit(Lower, Upper, I).
+// Sweeps the item boundaries in order, keeping the items containing the
+// current address in a heap, so costs O(N log N) time for O(N) segments.
+template <typename StartFunc, typename LimitFunc, typename EmitFunc>
+void containingSegments(size_t N, StartFunc StartOf, LimitFunc LimitOf,
+                        EmitFunc Emit) {
+  // Items which have started, largest index first. Items which have ended
+  // are dropped when they reach the top.
+  std::priority_queue<size_t> Active;
+  size_t Next = 0;
+  Addr Pos;
+  // The segment being extended, which is emitted once it is complete.
+  std::optional<std::tuple<Addr, Addr, size_t>> Pending;
+  while (Next < N || !Active.empty()) {
+    if (Active.empty())
+      Pos = std::max(Pos, StartOf(Next));
+    for (; Next < N && StartOf(Next) <= Pos; ++Next)
+      Active.push(Next);
+    while (!Active.empty() && LimitOf(Active.top()) <= Pos)
+      Active.pop();
+    if (Active.empty())
+      continue;
+
+    // The top item contains every address until it ends or a later item
+    // starts.
+    size_t I = Active.top();
+    Addr Upper = LimitOf(I);
+    if (Next < N)
+      Upper = std::min(Upper, StartOf(Next));
+    if (Pending && std::get<1>(*Pending) == Pos && std::get<2>(*Pending) == I) {
+      std::get<1>(*Pending) = Upper;
+    } else {
+      if (Pending)
+        std::apply(Emit, *Pending);
+      Pending.emplace(Pos, Upper, I);
+    }
+    Pos = Upper;
+  }
+  if (Pending)
+    std::apply(Emit, *Pending);
+}
+} // namespace
+
+FrozenModule::FrozenModule(const Module& M) {
+  SymbolsByName.reserve(M.Symbols->size());
+  for (const auto& S : M.symbols())
+    SymbolsByName.push_back({S.getName(), &S});
+
+  for (const auto& E : M.Symbols->get<Module::by_address>())
+    if (E.Address)
+      SymbolsByAddr.push_back({*E.Address, E.Sym});
+
+  for (const auto& D : M.data())
+    Data.push_back(&D);
+  std::stable_sort(Data.begin(), Data.end(),
+                   [](const DataObject* LHS, const DataObject* RHS) {
+                     return LHS->getAddress() < RHS->getAddress();
+                   });
+
+  DataSegments.reserve(M.DataAddrs->iterative_size());
+  for (const auto& [Interval, Objects] : *M.DataAddrs) {
+    size_t Begin = DataSegmentObjects.size();
+    DataSegmentObjects.insert(DataSegmentObjects.end(), Objects.begin(),
+                              Objects.end());
+    DataSegments.push_back({Interval.lower(), Interval.upper(), Begin,
+                            DataSegmentObjects.size()});
+  }
+
+  for (const auto& S : M.sections())
+    Sections.push_back(&S);
+  containingSegments(
+      Sections.size(), [this](size_t I) { return Sections[I]->getAddress(); },
+      [this](size_t I) { return addressLimit(*Sections[I]); },
+      [this](Addr Lower, Addr Upper, size_t I) {
+        SectionSegments.push_back({Lower, Upper, I});
+      });
+
+  SymbolicExprAddrs.reserve(M.SymbolicOperands->size());
+  SymbolicExprs.reserve(M.SymbolicOperands->size());
+  for (const auto& [A, SE] : *M.SymbolicOperands) {
+    SymbolicExprAddrs.push_back(A);
+    SymbolicExprs.push_back(SE);
+  }
+
+  const CFG& Cfg = M.getCFG();
+  size_t NumBlocks = num_vertices(Cfg);
+  size_t NumEdges = num_edges(Cfg);
+  // Vertex indices and edge offsets are stored in 32 bits.
+  Expects(NumBlocks <= std::numeric_limits<uint32_t>::max() &&
+          NumEdges <= std::numeric_limits<uint32_t>::max());
+  Blocks.reserve(NumBlocks);
+  SuccOffsets.reserve(NumBlocks + 1);
+  SuccTargets.reserve(NumEdges);
+  SuccLabels.reserve(NumEdges);
+  PredOffsets.reserve(NumBlocks + 1);
+  PredSources.reserve(NumEdges);
+  PredLabels.reserve(NumEdges);
+  for (auto V : boost::make_iterator_range(vertices(Cfg))) {
+    Blocks.push_back(Cfg[V]);
+
+    SuccOffsets.push_back(static_cast<uint32_t>(SuccTargets.size()));
+    for (auto E : boost::make_iterator_range(out_edges(V, Cfg))) {
+      SuccTargets.push_back(static_cast<uint32_t>(target(E, Cfg)));
+      SuccLabels.push_back(Cfg[E]);
+    }
+
+    PredOffsets.push_back(static_cast<uint32_t>(PredSources.size()));
+    for (auto E : boost::make_iterator_range(in_edges(V, Cfg))) {
+      PredSources.push_back(static_cast<uint32_t>(source(E, Cfg)));
+      PredLabels.push_back(Cfg[E]);
+    }
+  }
+  SuccOffsets.push_back(static_cast<uint32_t>(SuccTargets.size()));
+  PredOffsets.push_back(static_cast<uint32_t>(PredSources.size()));
+
+  M.blockColumns();
+  Columns = M.Columns;
+  auto Addresses = Columns->addresses();
+  auto Sizes = Columns->sizes();
+  containingSegments(
+      Columns->size(), [Addresses](size_t I) { return Addresses[I]; },
+      [Addresses, Sizes](size_t I) { return Addresses[I] + Sizes[I]; },
+      [this](Addr Lower, Addr Upper, size_t I) {
+        BlockSegments.push_back({Lower, Upper, I});
+      });
+}
+
+FrozenModule::symbol_range FrozenModule::symbols() const {
+  return boost::make_iterator_range(symbol_iterator(SymbolsByName.begin()),
+                                    symbol_iterator(SymbolsByName.end()));
+}
+
+FrozenModule::symbol_range FrozenModule::findSymbols(std::string_view N) const {
+  auto Found = std::equal_range(
+      SymbolsByName.begin(), SymbolsByName.end(), SymbolNameEntry{N, nullptr},
+      [](const SymbolNameEntry& LHS, const SymbolNameEntry& RHS) {
+        return LHS.Name < RHS.Name;
+      });
+  return boost::make_iterator_range(symbol_iterator(Found.first),
+                                    symbol_iterator(Found.second));
+}
+
+FrozenModule::symbol_range
+FrozenModule::findSymbolsByPrefix(std::string_view Prefix) const {
+  NamePrefix P{Prefix};
+  auto Begin = std::lower_bound(SymbolsByName.begin(), SymbolsByName.end(), P,
+                                [](const SymbolNameEntry& E, NamePrefix V) {
+                                  return comparePrefix(E.Name, V) < 0;
+                                });
+  auto End = std::upper_bound(Begin, SymbolsByName.end(), P,
+                              [](NamePrefix V, const SymbolNameEntry& E) {
+                                return comparePrefix(E.Name, V) > 0;
+                              });
+  return boost::make_iterator_range(symbol_iterator(Begin),
+                                    symbol_iterator(End));
+}
+
+FrozenModule::symbol_addr_range FrozenModule::findSymbols(Addr X) const {
+  auto Found = std::equal_range(
+      SymbolsByAddr.begin(), SymbolsByAddr.end(), SymbolAddrEntry{X, nullptr},
+      [](const SymbolAddrEntry& LHS, const SymbolAddrEntry& RHS) {
+        return LHS.Address < RHS.Address;
+      });
+  return boost::make_iterator_range(symbol_addr_iterator(Found.first),
+                                    symbol_addr_iterator(Found.second));
+}
+
+FrozenModule::symbol_addr_range FrozenModule::findSymbols(Addr Lower,
+                                                          Addr Upper) const {
+  auto ByAddr = [](const SymbolAddrEntry& E, Addr A) { return E.Address < A; };
+  auto Begin = std::lower_bound(SymbolsByAddr.begin(), SymbolsByAddr.end(),
+                                Lower, ByAddr);
+  auto End = std::lower_bound(Begin, SymbolsByAddr.end(), Upper, ByAddr);
+  return boost::make_iterator_range(symbol_addr_iterator(Begin),
+                                    symbol_addr_iterator(End));
+}
+
+FrozenModule::data_object_range FrozenModule::data() const {
+  return boost::make_iterator_range(data_object_iterator(Data.begin()),
+                                    data_object_iterator(Data.end()));
+}
+
+FrozenModule::data_object_range FrozenModule::findData(Addr X) const {
+  // Find the last segment starting at or before X.
+  auto It = std::upper_bound(
+      DataSegments.begin(), DataSegments.end(), X,
+      [](Addr A, const DataSegment& S) { return A < S.Lower; });
+  if (It == DataSegments.begin() || X >= std::prev(It)->Upper)
+    return boost::make_iterator_range(
+        data_object_iterator(DataSegmentObjects.end()),
+        data_object_iterator(DataSegmentObjects.end()));
+  --It;
+  return boost::make_iterator_range(
+      data_object_iterator(DataSegmentObjects.begin() + It->Begin),
+      data_object_iterator(DataSegmentObjects.begin() + It->End));
+}
+
+FrozenModule::section_range FrozenModule::sections() const {
+  return boost::make_iterator_range(section_iterator(Sections.begin()),
+                                    section_iterator(Sections.end()));
+}
+
+const Section* FrozenModule::findSection(Addr X) const {
+  auto It = std::lower_bound(
+      Sections.begin(), Sections.end(), X,
+      [](const Section* S, Addr A) { return S->getAddress() < A; });
+  if (It == Sections.end() || (*It)->getAddress() != X)
+    return nullptr;
+  return *It;
+}
+
+gsl::span<const SymbolicExpression>
+FrozenModule::findSymbolicExpression(Addr Lower, Addr Upper) const {
+  auto Begin = std::lower_bound(SymbolicExprAddrs.begin(),
+                                SymbolicExprAddrs.end(), Lower);
+  auto End = std::lower_bound(Begin, SymbolicExprAddrs.end(), Upper);
+  return gsl::span<const SymbolicExpression>(SymbolicExprs).subspan(
+      Begin - SymbolicExprAddrs.begin(), End - Begin);
+}
+
+const SymbolicExpression* FrozenModule::findSymbolicExpression(Addr X) const {
+  auto It =
+      std::lower_bound(SymbolicExprAddrs.begin(), SymbolicExprAddrs.end(), X);
+  if (It == SymbolicExprAddrs.end() || *It != X)
+    return nullptr;
+  return &SymbolicExprs[It - SymbolicExprAddrs.begin()];
+}
+
+FrozenModule::block_range FrozenModule::blocks() const {
+  return boost::make_iterator_range(block_iterator(Blocks.begin()),
+                                    block_iterator(Blocks.end()));
+}
+
+FrozenModule::adjacent_block_range
+FrozenModule::adjacent(const std::vector<uint32_t>& Offsets,
+                       const std::vector<uint32_t>& Indices,
+                       const Block& B) const {
+  size_t V = B.getVertex();
+  Expects(V < Blocks.size() && Blocks[V] == &B);
+  BlockIndexTransform F{Blocks.data()};
+  return boost::make_iterator_range(
+      adjacent_block_iterator(Indices.begin() + Offsets[V], F),
+      adjacent_block_iterator(Indices.begin() + Offsets[V + 1], F));
+}
+
+FrozenModule::adjacent_block_range
+FrozenModule::successors(const Block& B) const {
+  return adjacent(SuccOffsets, SuccTargets, B);
+}
+
+gsl::span<const EdgeLabel>
+FrozenModule::successorLabels(const Block& B) const {
+  size_t V = B.getVertex();
+  Expects(V < Blocks.size() && Blocks[V] == &B);
+  return gsl::span<const EdgeLabel>(SuccLabels).subspan(
+      SuccOffsets[V], SuccOffsets[V + 1] - SuccOffsets[V]);
+}
+
+FrozenModule::adjacent_block_range
+FrozenModule::predecessors(const Block& B) const {
+  return adjacent(PredOffsets, PredSources, B);
+}
+
+gsl::span<const EdgeLabel>
+FrozenModule::predecessorLabels(const Block& B) const {
+  size_t V = B.getVertex();
+  Expects(V < Blocks.size() && Blocks[V] == &B);
+  return gsl::span<const EdgeLabel>(PredLabels).subspan(
+      PredOffsets[V], PredOffsets[V + 1] - PredOffsets[V]);
+}
+
+FrozenModule::AddrContents FrozenModule::findContents(Addr X) const {
+  ContentsCursor C;
+  return findContents(X, C);
+}
+
+std::vector<FrozenModule::AddrContents>
+FrozenModule::findContents(gsl::span<const Addr> Addrs) const {
+  Expects(std::is_sorted(Addrs.begin(), Addrs.end()));
+  std::vector<AddrContents> Result;
+  Result.reserve(Addrs.size());
+  ContentsCursor C;
+  for (Addr X : Addrs)
+    Result.push_back(findContents(X, C));
+  return Result;
+}
+
+FrozenModule::AddrContents FrozenModule::findContents(Addr X,
+                                                      ContentsCursor& C) const {
+  AddrContents Result;
+
+  // Each cursor is left at the first entry starting after X, or for symbols
+  // and symbolic expressions at the first entry at X or after.
+  auto StartsByX = [X](const ContainingSegment& S) { return S.Lower <= X; };
+  auto SecEnd = gallop(SectionSegments.begin() + C.SectionSegment,
+                       SectionSegments.end(), StartsByX);
+  C.SectionSegment = SecEnd - SectionSegments.begin();
+  if (SecEnd != SectionSegments.begin() && X < std::prev(SecEnd)->Upper)
+    Result.Sec = Sections[std::prev(SecEnd)->Index];
+
+  auto BlockEnd = gallop(BlockSegments.begin() + C.BlockSegment,
+                         BlockSegments.end(), StartsByX);
+  C.BlockSegment = BlockEnd - BlockSegments.begin();
+  if (BlockEnd != BlockSegments.begin() && X < std::prev(BlockEnd)->Upper)
+    Result.Blk = &Columns->block(
+        static_cast<BlockColumns::Index>(std::prev(BlockEnd)->Index));
+
+  auto SegEnd =
+      gallop(DataSegments.begin() + C.DataSegment, DataSegments.end(),
+             [X](const DataSegment& S) { return S.Lower <= X; });
+  C.DataSegment = SegEnd - DataSegments.begin();
+  auto ObjectsBegin = DataSegmentObjects.begin();
+  auto ObjectsEnd = ObjectsBegin;
+  if (SegEnd != DataSegments.begin() && X < std::prev(SegEnd)->Upper) {
+    ObjectsBegin += std::prev(SegEnd)->Begin;
+    ObjectsEnd += std::prev(SegEnd)->End;
+  }
+  Result.Data = boost::make_iterator_range(data_object_iterator(ObjectsBegin),
+                                           data_object_iterator(ObjectsEnd));
+
+  auto SymBegin =
+      gallop(SymbolsByAddr.begin() + C.Symbol, SymbolsByAddr.end(),
+             [X](const SymbolAddrEntry& E) { return E.Address < X; });
+  auto SymEnd =
+      gallop(SymBegin, SymbolsByAddr.end(),
+             [X](const SymbolAddrEntry& E) { return E.Address <= X; });
+  C.Symbol = SymBegin - SymbolsByAddr.begin();
+  Result.Symbols = boost::make_iterator_range(symbol_addr_iterator(SymBegin),
+                                              symbol_addr_iterator(SymEnd));
+
+  auto SEIt = gallop(SymbolicExprAddrs.begin() + C.SymbolicExpr,
+                     SymbolicExprAddrs.end(), [X](Addr A) { return A < X; });
+  C.SymbolicExpr = SEIt - SymbolicExprAddrs.begin();
+  if (SEIt != SymbolicExprAddrs.end() && *SEIt == X)
+    Result.SymbolicExpr = &SymbolicExprs[C.SymbolicExpr];
+
+  auto RegionEnd =
+      gallop(ByteRegions.begin() + C.Region, ByteRegions.end(),
+             [X](const ByteMap::Region& R) { return R.Address <= X; });
+  C.Region = RegionEnd - ByteRegions.begin();
+  if (RegionEnd != ByteRegions.begin()) {
+    const auto& R = *std::prev(RegionEnd);
+    auto Offset = static_cast<uint64_t>(X - R.Address);
+    if (Offset < R.Data->size())
+      Result.Bytes = gsl::span<const std::byte>(*R.Data).subspan(Offset);
+  }
+  return Result;
+}
+
+FrozenModule::AddrRangeContents FrozenModule::findContents(Addr Lower,
+                                                           Addr Upper) const {
+  AddrRangeContents Result;
+
+  auto ByStart = [](const auto* N, Addr A) { return N->getAddress() < A; };
+  auto SecBegin =
+      std::lower_bound(Sections.begin(), Sections.end(), Lower, ByStart);
+  auto SecEnd = std::lower_bound(SecBegin, Sections.end(), Upper, ByStart);
+  Result.Sections = boost::make_iterator_range(section_iterator(SecBegin),
+                                               section_iterator(SecEnd));
+
+  Result.Blocks = Columns->findBlocks(Lower, Upper);
+
+  auto DataBegin = std::lower_bound(Data.begin(), Data.end(), Lower, ByStart);
+  auto DataEnd = std::lower_bound(DataBegin, Data.end(), Upper, ByStart);
+  Result.Data = boost::make_iterator_range(data_object_iterator(DataBegin),
+                                           data_object_iterator(DataEnd));
+
+  Result.Symbols = findSymbols(Lower, Upper);
+  Result.SymbolicExprs = findSymbolicExpression(Lower, Upper);
+
+  auto RegionEnd = std::upper_bound(
+      ByteRegions.begin(), ByteRegions.end(), Lower,
+      [](Addr A, const ByteMap::Region& R) { return A < R.Address; });
+  if (RegionEnd != ByteRegions.begin() && Lower < Upper) {
+    const auto& R = *std::prev(RegionEnd);
+    auto Offset = static_cast<uint64_t>(Lower - R.Address);
+    auto Size = static_cast<uint64_t>(Upper - Lower);
+    if (Offset + Size <= R.Data->size())
+      Result.Bytes =
+          gsl::span<const std::byte>(*R.Data).subspan(Offset, Size);
+  }
+  return Result;
+}
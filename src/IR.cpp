@@ -13,8 +13,11 @@
 //
 //===----------------------------------------------------------------------===//
 #include "IR.hpp"
+#include "Parallel.hpp"
+#include "PhaseTimer.hpp"
 #include "Serialization.hpp"
 #include <gtirb/AuxData.hpp>
+#include <gtirb/AuxDataTypeRegistry.hpp>
 #include <gtirb/DataObject.hpp>
 #include <gtirb/ImageByteMap.hpp>
 #include <gtirb/Module.hpp>
@@ -23,6 +26,9 @@
 #include <gtirb/SymbolicExpression.hpp>
 #include <proto/IR.pb.h>
 #include <google/protobuf/util/json_util.h>
+#include <algorithm>
+#include <mutex>
+#include <utility>
 
 using namespace gtirb;
 
@@ -59,30 +65,375 @@ bool IR::removeAuxData(const std::string& X) {
   return false;
 }
 
+void IR::merge(IR& Other) {
+  Expects(&Other.getContext() == &getContext());
+  if (&Other == this)
+    return;
+  // The modules are observed by this IR's index instead, if it is built.
+  for (size_t I = 0; I < Other.IndexObservers.size(); ++I)
+    Other.Modules[I]->removeObserver(*Other.IndexObservers[I]);
+  Other.IndexObservers.clear();
+  Other.SymbolIndex.clear();
+  for (Module* M : Other.Modules)
+    addModule(M);
+  Other.Modules.clear();
+  AuxDatas.merge(Other.AuxDatas);
+}
+
+// Whether a symbol belongs in the global symbol index.
+static bool isGlobalSymbol(const Symbol& S) {
+  switch (S.getStorageKind()) {
+  case Symbol::StorageKind::Normal:
+  case Symbol::StorageKind::Static:
+  case Symbol::StorageKind::Extern:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void IR::indexSymbols() const {
+  PhaseTimer Timer(getContext(), "IR::indexSymbols");
+  Timer.setNodes(this->Modules.size());
+
+  for (size_t I = this->IndexObservers.size(); I < this->Modules.size(); ++I) {
+    this->IndexObservers.push_back(std::make_unique<SymbolIndexObserver>(I));
+    this->Modules[I]->addObserver(*this->IndexObservers.back());
+  }
+
+  // Sort each module's symbols into shards, then build each shard from the
+  // modules' contributions, in module order. Changes the observers have
+  // yet to receive are already reflected, and applying them again leaves
+  // the index unchanged.
+  using Contribution = std::vector<std::vector<const Symbol*>>;
+  std::vector<Contribution> Contributions(this->Modules.size());
+  parallelFor(this->Modules.size(), [this, &Contributions](size_t I) {
+    Contribution& C = Contributions[I];
+    C.resize(SymbolIndexShards);
+    auto& Names = this->IndexObservers[I]->Names;
+    Names.clear();
+    for (const Symbol& S : this->Modules[I]->symbols()) {
+      if (isGlobalSymbol(S)) {
+        std::string_view Name = S.getName();
+        Names.emplace(&S, Name);
+        C[symbolIndexShard(Name)].push_back(&S);
+      }
+    }
+  });
+
+  std::vector<SymbolIndexShard> Shards(SymbolIndexShards);
+  parallelFor(SymbolIndexShards, [&Contributions, &Shards](size_t I) {
+    for (size_t P = 0; P < Contributions.size(); ++P) {
+      for (const Symbol* S : Contributions[P][I]) {
+        SymbolIndexEntry& E = Shards[I][S->getName()];
+        E.Symbols.push_back(S);
+        E.Positions.push_back(P);
+      }
+    }
+  });
+  this->SymbolIndex = std::move(Shards);
+  for (auto& O : this->IndexObservers)
+    O->Shards = this->SymbolIndex.data();
+}
+
+void IR::indexModuleSymbols(Module& M) const {
+  auto O = std::make_unique<SymbolIndexObserver>(this->IndexObservers.size());
+  O->Shards = this->SymbolIndex.data();
+  for (const Symbol& S : M.symbols())
+    O->insert(&S);
+  M.addObserver(*O);
+  this->IndexObservers.push_back(std::move(O));
+}
+
+void IR::SymbolIndexObserver::insert(const Symbol* S) {
+  if (!isGlobalSymbol(*S))
+    return;
+  std::string_view Name = S->getName();
+  SymbolIndexEntry& E = Shards[symbolIndexShard(Name)][Name];
+  auto At = std::upper_bound(E.Positions.begin(), E.Positions.end(), Position);
+  E.Symbols.insert(E.Symbols.begin() + (At - E.Positions.begin()), S);
+  E.Positions.insert(At, Position);
+  Names.emplace(S, Name);
+}
+
+void IR::SymbolIndexObserver::erase(const Symbol* S) {
+  auto Found = Names.find(S);
+  if (Found == Names.end())
+    return;
+  SymbolIndexShard& Shard = Shards[symbolIndexShard(Found->second)];
+  auto It = Shard.find(Found->second);
+  SymbolIndexEntry& E = It->second;
+  // Entries are ordered by position; find this module's entry for S.
+  auto [Begin, End] =
+      std::equal_range(E.Positions.begin(), E.Positions.end(), Position);
+  auto From = E.Symbols.begin() + (Begin - E.Positions.begin());
+  auto At = std::find(From, From + (End - Begin), S);
+  E.Positions.erase(E.Positions.begin() + (At - E.Symbols.begin()));
+  E.Symbols.erase(At);
+  if (E.Symbols.empty())
+    Shard.erase(It);
+  Names.erase(Found);
+}
+
+void IR::SymbolIndexObserver::changed(const Module&,
+                                      gsl::span<const ModuleChange> Changes) {
+  // Re-index each symbol mentioned under its current name and storage kind,
+  // so that a change which is already reflected is harmless.
+  for (const ModuleChange& C : Changes) {
+    switch (C.What) {
+    case ModuleChange::Kind::SymbolAdded:
+    case ModuleChange::Kind::SymbolChanged: {
+      const auto* S = cast<Symbol>(C.Item);
+      erase(S);
+      insert(S);
+      break;
+    }
+    case ModuleChange::Kind::SymbolRemoved:
+      erase(cast<Symbol>(C.Item));
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+IR::const_global_symbol_range
+IR::findGlobalSymbols(const std::string& Name) const {
+  static const std::vector<const Symbol*> None;
+  if (this->SymbolIndex.empty())
+    indexSymbols();
+  const SymbolIndexShard& Shard = this->SymbolIndex[symbolIndexShard(Name)];
+  auto Found = Shard.find(Name);
+  const auto& Syms = Found == Shard.end() ? None : Found->second.Symbols;
+  return const_global_symbol_range(Syms.begin(), Syms.end());
+}
+
+bool IR::runAuxDataDecodeTasks(const std::vector<AuxDataDecodeTask>& Tasks) {
+  // Decoding a table only touches that table, so distinct tables can be
+  // decoded concurrently. Run each table's first task only.
+  std::vector<const AuxDataDecodeTask*> Unique;
+  bool AllFound = true;
+  for (const auto& T : Tasks) {
+    if (T.Table == nullptr) {
+      AllFound = false;
+      continue;
+    }
+    if (std::none_of(Unique.begin(), Unique.end(),
+                     [&T](const AuxDataDecodeTask* U) {
+                       return U->Table == T.Table;
+                     }))
+      Unique.push_back(&T);
+  }
+
+  std::vector<char> Decoded(Unique.size());
+  parallelFor(Unique.size(), [&Unique, &Decoded](size_t I) {
+    Decoded[I] = Unique[I]->Decode(*Unique[I]->Table);
+  });
+  return AllFound && std::all_of(Decoded.begin(), Decoded.end(),
+                                 [](char D) { return D != 0; });
+}
+
+bool IR::decodeAuxData(const AuxDataTypeRegistry& Registry) {
+  std::vector<AuxDataDecodeTask> Tasks;
+  bool AllRegistered = true;
+  for (auto& [Name, Table] : this->AuxDatas) {
+    if (const auto* Entry = Registry.findFor(Table))
+      Tasks.push_back({&Table, Entry->Decode});
+    else
+      AllRegistered = false;
+  }
+  return runAuxDataDecodeTasks(Tasks) && AllRegistered;
+}
+
+// The total size of the encoded data of some AuxData messages.
+static uint64_t
+auxDataBytes(const google::protobuf::Map<std::string, proto::AuxData>& Map) {
+  uint64_t Bytes = 0;
+  for (const auto& Entry : Map)
+    Bytes += Entry.second.data().size();
+  return Bytes;
+}
+
+// Initialize an AuxData from a message, taking its serialized contents.
+// fromProtobuf is a friend of AuxData, found by argument-dependent lookup,
+// which does not apply within members of IR.
+static void auxDataFromProtobuf(Context& C, AuxData& Result,
+                                proto::AuxData&& Message) {
+  fromProtobuf(C, Result, std::move(Message));
+}
+
 void IR::toProtobuf(MessageType* Message) const {
   nodeUUIDToBytes(this, *Message->mutable_uuid());
-  containerToProtobuf(this->Modules, Message->mutable_modules());
-  containerToProtobuf(this->AuxDatas, Message->mutable_aux_data());
+  {
+    PhaseTimer Timer(getContext(), "IR::toProtobuf/modules");
+    Timer.setNodes(this->Modules.size());
+    containerToProtobuf(this->Modules, Message->mutable_modules());
+  }
+
+  // AuxData tables are independent of each other, so encode them
+  // concurrently, then insert the results into the message in order.
+  PhaseTimer Timer(getContext(), "IR::toProtobuf/auxData");
+  Timer.setNodes(this->AuxDatas.size());
+  std::vector<const AuxDataSet::value_type*> Tables;
+  Tables.reserve(this->AuxDatas.size());
+  for (const auto& Entry : this->AuxDatas)
+    Tables.push_back(&Entry);
+  std::vector<proto::AuxData> Encoded(Tables.size());
+  parallelFor(Tables.size(), [&Tables, &Encoded](size_t I) {
+    Encoded[I] = gtirb::toProtobuf(Tables[I]->second);
+  });
+  if (Timer.enabled()) {
+    uint64_t Bytes = 0;
+    for (const auto& M : Encoded)
+      Bytes += M.data().size();
+    Timer.setBytes(Bytes);
+  }
+
+  auto* AuxDataMessages = Message->mutable_aux_data();
+  for (size_t I = 0; I < Tables.size(); ++I)
+    (*AuxDataMessages)[Tables[I]->first] = std::move(Encoded[I]);
 }
 
 IR* IR::fromProtobuf(Context& C, const MessageType& Message) {
+  RegistrationTimer Registration(C);
   auto* I = IR::Create(C);
   setNodeUUIDFromBytes(I, Message.uuid());
-  containerFromProtobuf(C, I->Modules, Message.modules());
+  {
+    PhaseTimer Timer(C, "IR::fromProtobuf/modules");
+    Timer.setNodes(Message.modules_size());
+    containerFromProtobuf(C, I->Modules, Message.modules());
+  }
+  PhaseTimer Timer(C, "IR::fromProtobuf/auxData");
+  Timer.setNodes(Message.aux_data_size());
+  if (Timer.enabled())
+    Timer.setBytes(auxDataBytes(Message.aux_data()));
   containerFromProtobuf(C, I->AuxDatas, Message.aux_data());
   return I;
 }
 
+IR* IR::fromProtobuf(Context& C, MessageType&& Message) {
+  RegistrationTimer Registration(C);
+  auto* I = IR::Create(C);
+  setNodeUUIDFromBytes(I, Message.uuid());
+  {
+    PhaseTimer Timer(C, "IR::fromProtobuf/modules");
+    Timer.setNodes(Message.modules_size());
+    containerFromProtobuf(C, I->Modules, Message.modules());
+  }
+  // Move the encoded data of each table rather than copying it.
+  PhaseTimer Timer(C, "IR::fromProtobuf/auxData");
+  Timer.setNodes(Message.aux_data_size());
+  if (Timer.enabled())
+    Timer.setBytes(auxDataBytes(Message.aux_data()));
+  for (auto& [Name, AuxMessage] : *Message.mutable_aux_data())
+    auxDataFromProtobuf(C, I->AuxDatas[Name], std::move(AuxMessage));
+  return I;
+}
+
+namespace {
+// Defers the phases reported while work runs on other threads, and reports
+// them to the Context's own sink once the work is done, on the thread which
+// started it.
+class DeferredStatsSink : public StatsSink {
+public:
+  explicit DeferredStatsSink(Context& C) : Ctx(C), Sink(C.getStatsSink()) {
+    if (Sink)
+      Ctx.setStatsSink(this);
+  }
+
+  DeferredStatsSink(const DeferredStatsSink&) = delete;
+  DeferredStatsSink& operator=(const DeferredStatsSink&) = delete;
+
+  ~DeferredStatsSink() override {
+    if (Sink) {
+      Ctx.setStatsSink(Sink);
+      for (const auto& S : Deferred)
+        Sink->record(S);
+    }
+  }
+
+  void record(const PhaseStats& S) override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Deferred.push_back(S);
+  }
+
+private:
+  Context& Ctx;
+  StatsSink* Sink;
+  std::mutex Mutex;
+  std::vector<PhaseStats> Deferred;
+};
+} // namespace
+
 void IR::save(std::ostream& Out) const {
-  MessageType Message;
-  this->toProtobuf(&Message);
-  Message.SerializeToOstream(&Out);
+  // The encoding of a message is the concatenation of the encodings of its
+  // fields, and that of a repeated or map field the concatenation of the
+  // encodings of its elements. So encode each module, and each AuxData table
+  // with its name, as a proto::IR holding only that element, concurrently,
+  // and write the results in the order SerializeToOstream would.
+  Context& C = getContext();
+  std::vector<std::string> Parts(1 + this->AuxDatas.size() +
+                                 this->Modules.size());
+  {
+    MessageType Header;
+    nodeUUIDToBytes(this, *Header.mutable_uuid());
+    Header.SerializeToString(&Parts[0]);
+  }
+
+  {
+    PhaseTimer Timer(C, "IR::toProtobuf/auxData");
+    Timer.setNodes(this->AuxDatas.size());
+    std::vector<const AuxDataSet::value_type*> Tables;
+    Tables.reserve(this->AuxDatas.size());
+    for (const auto& Entry : this->AuxDatas)
+      Tables.push_back(&Entry);
+    std::vector<uint64_t> Bytes(Tables.size());
+    std::string* Encoded = &Parts[1];
+    parallelFor(Tables.size(), [&Tables, &Bytes, Encoded](size_t I) {
+      MessageType Part;
+      auto& Table = (*Part.mutable_aux_data())[Tables[I]->first];
+      Table = gtirb::toProtobuf(Tables[I]->second);
+      Bytes[I] = Table.data().size();
+      Part.SerializeToString(&Encoded[I]);
+    });
+    if (Timer.enabled()) {
+      uint64_t Total = 0;
+      for (uint64_t B : Bytes)
+        Total += B;
+      Timer.setBytes(Total);
+    }
+  }
+
+  {
+    PhaseTimer Timer(C, "IR::toProtobuf/modules");
+    Timer.setNodes(this->Modules.size());
+    DeferredStatsSink Stats(C);
+    std::string* Encoded = &Parts[1 + this->AuxDatas.size()];
+    parallelFor(this->Modules.size(), [this, Encoded](size_t I) {
+      MessageType Part;
+      this->Modules[I]->toProtobuf(Part.add_modules());
+      Part.SerializeToString(&Encoded[I]);
+    });
+  }
+
+  PhaseTimer Timer(C, "IR::save/serialize");
+  uint64_t Bytes = 0;
+  for (const auto& Part : Parts) {
+    Out.write(Part.data(), static_cast<std::streamsize>(Part.size()));
+    Bytes += Part.size();
+  }
+  Timer.setBytes(Bytes);
 }
 
 IR* IR::load(Context& C, std::istream& In) {
   MessageType Message;
-  Message.ParseFromIstream(&In);
-  return IR::fromProtobuf(C, Message);
+  {
+    PhaseTimer Timer(C, "IR::load/parse");
+    Message.ParseFromIstream(&In);
+    if (Timer.enabled())
+      Timer.setBytes(Message.ByteSizeLong());
+  }
+  return IR::fromProtobuf(C, std::move(Message));
 }
 
 void IR::saveJSON(std::ostream& Out) const {
@@ -98,5 +449,5 @@ IR* IR::loadJSON(Context& C, std::istream& In) {
   std::string S;
   google::protobuf::util::JsonStringToMessage(
       std::string(std::istreambuf_iterator<char>(In), {}), &Message);
-  return IR::fromProtobuf(C, Message);
+  return IR::fromProtobuf(C, std::move(Message));
 }
@@ -13,26 +13,387 @@
 //
 //===----------------------------------------------------------------------===//
 #include "Module.hpp"
+#include "PhaseTimer.hpp"
 #include "Serialization.hpp"
 #include <gtirb/Block.hpp>
 #include <gtirb/CFG.hpp>
+#include <gtirb/FrozenModule.hpp>
 #include <gtirb/ImageByteMap.hpp>
+#include <gtirb/ModuleObserver.hpp>
 #include <gtirb/SymbolicExpression.hpp>
 #include <proto/Module.pb.h>
 #include <gsl/gsl>
+#include <algorithm>
+#include <cassert>
 #include <map>
+#include <optional>
+#include <vector>
 
 using namespace gtirb;
 
 Module::Module(Context& C)
     : Node(C, Kind::Module), ImageBytes(ImageByteMap::Create(C)) {}
 
+Module::~Module() noexcept {
+  if (Sharers) {
+    auto& Modules = Sharers->Modules;
+    Modules.erase(std::remove(Modules.begin(), Modules.end(), this),
+                  Modules.end());
+  }
+}
+
 gtirb::ImageByteMap& Module::getImageByteMap() { return *this->ImageBytes; }
 
 const gtirb::ImageByteMap& Module::getImageByteMap() const {
   return *this->ImageBytes;
 }
 
+const BlockColumns& Module::blockColumns() const {
+  if (!Columns)
+    Columns = std::make_shared<const BlockColumns>(*Cfg);
+  return *Columns;
+}
+
+FrozenModule Module::freeze() const {
+  FrozenModule F(*this);
+  F.ByteRegions = ImageBytes->BMap.Regions;
+  return F;
+}
+
+Module* Module::clone() const {
+  Context& C = getContext();
+  Module* M = Module::Create(C);
+  M->BinaryPath = BinaryPath;
+  M->PreferredAddr = PreferredAddr;
+  M->RebaseDelta = RebaseDelta;
+  M->FileFormat = FileFormat;
+  M->IsaID = IsaID;
+  M->Name = Name;
+  M->Cfg = Cfg;
+  M->Columns = Columns;
+  M->Data = Data;
+  M->DataAddrs = DataAddrs;
+  M->Sections = Sections;
+  M->Symbols = Symbols;
+  M->SymbolicOperands = SymbolicOperands;
+  M->SymbolReferences = SymbolReferences;
+
+  // Copying the regions shares their bytes.
+  ImageByteMap* IBM = M->ImageBytes;
+  IBM->BMap.Regions = ImageBytes->BMap.Regions;
+  IBM->EaMinMax = ImageBytes->EaMinMax;
+  IBM->BaseAddress = ImageBytes->BaseAddress;
+  IBM->EntryPointAddress = ImageBytes->EntryPointAddress;
+  IBM->ByteOrder = ImageBytes->ByteOrder;
+
+  if (!Sharers)
+    Sharers = std::make_shared<SymbolSharers>();
+  if (Sharers->Modules.empty())
+    Sharers->Modules.push_back(const_cast<Module*>(this));
+  Sharers->Modules.push_back(M);
+  M->Sharers = Sharers;
+  return M;
+}
+
+bool Module::sharesSymbol(const Symbol& S) const {
+  if (!Sharers)
+    return false;
+  Symbol* Key = const_cast<Symbol*>(&S);
+  for (const Module* Other : Sharers->Modules)
+    if (Other != this && Other->Symbols->find(Key) != Other->Symbols->end())
+      return true;
+  return false;
+}
+
+Symbol& Module::ownSymbol(Symbol& S) {
+  assert(Symbols->find(&S) != Symbols->end() && "Symbol is not in module");
+  if (!sharesSymbol(S))
+    return S;
+
+  Symbol* Copy = Symbol::Create(getContext());
+  Copy->Payload = S.Payload;
+  Copy->Name = S.Name;
+  Copy->Storage = S.Storage;
+  replaceSymbol(S, *Copy);
+  record(ReplacedSymbol{&S, Copy});
+  return *Copy;
+}
+
+void Module::replaceSymbol(Symbol& From, Symbol& To) {
+  auto& Syms = Symbols.mut();
+  Syms.erase(&From);
+  Syms.insert(makeSymbolEntry(&To));
+
+  // Refer to To from each symbolic expression which referred to From.
+  auto& References = SymbolReferences.mut();
+  auto [Begin, End] = References.equal_range(&From);
+  if (Begin == End)
+    return;
+  std::vector<Addr> Addrs;
+  for (auto It = Begin; It != End; ++It)
+    Addrs.push_back(It->second);
+  References.erase(Begin, End);
+  auto& Operands = SymbolicOperands.mut();
+  auto Replace = [&From, &To](Symbol*& Sym) {
+    if (Sym == &From)
+      Sym = &To;
+  };
+  for (Addr X : Addrs) {
+    auto It = Operands.find(X, SymbolicExpressionElementAddrComparator{});
+    Operands.modify(It, [&Replace](SymbolicExpressionElement& E) {
+      std::visit(
+          [&Replace](auto& Expr) {
+            using T = std::decay_t<decltype(Expr)>;
+            if constexpr (std::is_same_v<T, SymAddrAddr>) {
+              Replace(Expr.Sym1);
+              Replace(Expr.Sym2);
+            } else {
+              Replace(Expr.Sym);
+            }
+          },
+          E.second);
+    });
+    References.emplace(&To, X);
+  }
+}
+
+// The most recently added edge from From to To, if any.
+static std::optional<CFG::edge_descriptor>
+lastEdge(const CFG& G, const Block* From, const Block* To) {
+  std::optional<CFG::edge_descriptor> Last;
+  auto [Begin, End] = out_edges(From->getVertex(), G);
+  for (auto It = Begin; It != End; ++It)
+    if (target(*It, G) == To->getVertex())
+      Last = *It;
+  return Last;
+}
+
+void Module::beginTransaction() {
+  ImageBytes->BMap.Recording = true;
+  Savepoints.push_back({UndoLog.size(), ImageBytes->BMap.Changes.size()});
+}
+
+void Module::commitTransaction() {
+  assert(!Savepoints.empty() && "No transaction is open");
+  Savepoints.pop_back();
+  if (Savepoints.empty()) {
+    UndoLog.clear();
+    ImageBytes->BMap.Changes.clear();
+    ImageBytes->BMap.Recording = false;
+  }
+}
+
+void Module::rollbackTransaction() {
+  assert(!Savepoints.empty() && "No transaction is open");
+  Savepoint SP = Savepoints.back();
+  Savepoints.pop_back();
+
+  while (UndoLog.size() > SP.Changes) {
+    undo(UndoLog.back());
+    UndoLog.pop_back();
+  }
+  ImageBytes->BMap.undoChanges(SP.ByteChanges);
+  if (Savepoints.empty())
+    ImageBytes->BMap.Recording = false;
+}
+
+CFG::edge_descriptor gtirb::addEdge(const Block* From, const Block* To,
+                                    Module& M) {
+  auto E = addEdge(From, To, M.getCFG());
+  M.record(Module::AddedEdge{From, To});
+  return E;
+}
+
+bool gtirb::removeEdge(const Block* From, const Block* To, Module& M) {
+  CFG& G = M.getCFG();
+  auto E = lastEdge(G, From, To);
+  if (!E)
+    return false;
+  M.record(Module::RemovedEdge{From, To, G[*E]});
+  remove_edge(*E, G);
+  return true;
+}
+
+void Module::addObserver(ModuleObserver& O) {
+  if (Observers.empty())
+    ImageBytes->BMap.Tracking = true;
+  else
+    notifyObservers();
+  Observers.push_back(&O);
+}
+
+void Module::removeObserver(ModuleObserver& O) {
+  Observers.erase(std::remove(Observers.begin(), Observers.end(), &O),
+                  Observers.end());
+  if (Observers.empty()) {
+    PendingChanges.clear();
+    ImageBytes->BMap.Tracking = false;
+    ImageBytes->BMap.Written.clear();
+  }
+}
+
+void Module::notifyObservers() {
+  if (Observers.empty())
+    return;
+
+  auto& Written = ImageBytes->BMap.Written;
+  if (!Written.empty()) {
+    AddrRangeSet Ranges(std::move(Written));
+    for (const auto& R : Ranges.ranges())
+      PendingChanges.push_back(
+          {ModuleChange::Kind::BytesChanged, nullptr, nullptr, R.lower(),
+           R.size()});
+    Written.clear();
+  }
+
+  if (PendingChanges.empty())
+    return;
+  // Observers may change the module; report those changes in a new batch.
+  std::vector<ModuleChange> Batch;
+  Batch.swap(PendingChanges);
+  for (ModuleObserver* O : Observers)
+    O->changed(*this, Batch);
+}
+
+void Module::report(const Change& C) {
+  std::visit(
+      [this](const auto& Ch) {
+        using T = std::decay_t<decltype(Ch)>;
+        if constexpr (std::is_same_v<T, AddedSymbol>) {
+          report(ModuleChange::Kind::SymbolAdded, Ch.S);
+        } else if constexpr (std::is_same_v<T, ChangedSymbol>) {
+          report(ModuleChange::Kind::SymbolChanged, Ch.S);
+        } else if constexpr (std::is_same_v<T, ReplacedSymbol>) {
+          report(ModuleChange::Kind::SymbolRemoved, Ch.From);
+          report(ModuleChange::Kind::SymbolAdded, Ch.To);
+        } else if constexpr (std::is_same_v<T, AddedData>) {
+          report(ModuleChange::Kind::DataAdded, Ch.D);
+        } else if constexpr (std::is_same_v<T, AddedSection>) {
+          report(ModuleChange::Kind::SectionAdded, Ch.S);
+        } else if constexpr (std::is_same_v<T, AddedSymbolicExpression>) {
+          PendingChanges.push_back(
+              {ModuleChange::Kind::SymbolicExpressionAdded, nullptr, nullptr,
+               Ch.A, 0});
+        } else if constexpr (std::is_same_v<T, AddedBlock>) {
+          report(ModuleChange::Kind::BlockAdded, Ch.B);
+        } else if constexpr (std::is_same_v<T, AddedEdge>) {
+          report(ModuleChange::Kind::EdgeAdded, Ch.From, Ch.To);
+        } else {
+          report(ModuleChange::Kind::EdgeRemoved, Ch.From, Ch.To);
+        }
+      },
+      C);
+}
+
+void Module::undo(const Change& C) {
+  std::visit(
+      [this](const auto& Ch) {
+        using T = std::decay_t<decltype(Ch)>;
+        if constexpr (std::is_same_v<T, AddedSymbol>) {
+          Symbols.mut().erase(Ch.S);
+          report(ModuleChange::Kind::SymbolRemoved, Ch.S);
+        } else if constexpr (std::is_same_v<T, ChangedSymbol>) {
+          changeSymbol(*Ch.S, [&Ch] {
+            Ch.S->Name = Ch.Name;
+            Ch.S->Payload = Ch.Payload;
+          });
+          report(ModuleChange::Kind::SymbolChanged, Ch.S);
+        } else if constexpr (std::is_same_v<T, ReplacedSymbol>) {
+          replaceSymbol(*Ch.To, *Ch.From);
+          report(ModuleChange::Kind::SymbolRemoved, Ch.To);
+          report(ModuleChange::Kind::SymbolAdded, Ch.From);
+        } else if constexpr (std::is_same_v<T, AddedData>) {
+          Data.mut().erase(Ch.D);
+          DataAddrs.mut().subtract(
+              std::make_pair(DataIntMap::interval_type::right_open(
+                                 Ch.D->getAddress(), addressLimit(*Ch.D)),
+                             DataSet{Ch.D}));
+          report(ModuleChange::Kind::DataRemoved, Ch.D);
+        } else if constexpr (std::is_same_v<T, AddedSection>) {
+          Sections.mut().erase(Ch.S->getAddress());
+          report(ModuleChange::Kind::SectionRemoved, Ch.S);
+        } else if constexpr (std::is_same_v<T, AddedSymbolicExpression>) {
+          auto& Operands = SymbolicOperands.mut();
+          auto It =
+              Operands.find(Ch.A, SymbolicExpressionElementAddrComparator{});
+          removeSymbolReferences(Ch.A, It->second);
+          Operands.erase(It);
+          if (!Observers.empty())
+            PendingChanges.push_back(
+                {ModuleChange::Kind::SymbolicExpressionRemoved, nullptr,
+                 nullptr, Ch.A, 0});
+        } else if constexpr (std::is_same_v<T, AddedBlock>) {
+          // Blocks are removed in the reverse of the order they were added,
+          // so each is the last vertex, and removing it renumbers no others.
+          CFG& G = getCFG();
+          auto V = Ch.B->getVertex();
+          assert(V + 1 == num_vertices(G) &&
+                 "Blocks added through getCFG must be removed first");
+          clear_vertex(V, G);
+          remove_vertex(V, G);
+          report(ModuleChange::Kind::BlockRemoved, Ch.B);
+        } else if constexpr (std::is_same_v<T, AddedEdge>) {
+          CFG& G = getCFG();
+          remove_edge(*lastEdge(G, Ch.From, Ch.To), G);
+          report(ModuleChange::Kind::EdgeRemoved, Ch.From, Ch.To);
+        } else {
+          CFG& G = getCFG();
+          G[gtirb::addEdge(Ch.From, Ch.To, G)] = Ch.Label;
+          report(ModuleChange::Kind::EdgeAdded, Ch.From, Ch.To);
+        }
+      },
+      C);
+}
+
+void Module::removeSymbolReferences(Addr X, const SymbolicExpression& SE) {
+  auto& References = SymbolReferences.mut();
+  auto Remove = [&References, X](const Symbol* S) {
+    auto [Begin, End] = References.equal_range(S);
+    auto It = std::find_if(Begin, End,
+                           [X](const auto& Ref) { return Ref.second == X; });
+    if (It != End)
+      References.erase(It);
+  };
+  std::visit(
+      [&Remove](const auto& E) {
+        using T = std::decay_t<decltype(E)>;
+        if constexpr (std::is_same_v<T, SymAddrAddr>) {
+          if (E.Sym1)
+            Remove(E.Sym1);
+          if (E.Sym2 && E.Sym2 != E.Sym1)
+            Remove(E.Sym2);
+        } else if (E.Sym) {
+          Remove(E.Sym);
+        }
+      },
+      SE);
+}
+
+void Module::addSymbolReferences(Addr X, const SymbolicExpression& SE) {
+  auto& References = SymbolReferences.mut();
+  std::visit(
+      [&References, X](const auto& E) {
+        using T = std::decay_t<decltype(E)>;
+        if constexpr (std::is_same_v<T, SymAddrAddr>) {
+          if (E.Sym1)
+            References.emplace(E.Sym1, X);
+          if (E.Sym2 && E.Sym2 != E.Sym1)
+            References.emplace(E.Sym2, X);
+        } else if (E.Sym) {
+          References.emplace(E.Sym, X);
+        }
+      },
+      SE);
+}
+
+// The number of bytes held by a serialized ImageByteMap.
+static uint64_t byteMapBytes(const proto::ImageByteMap& Message) {
+  uint64_t Bytes = 0;
+  for (const auto& Region : Message.byte_map().regions())
+    Bytes += Region.data().size();
+  return Bytes;
+}
+
 void Module::toProtobuf(MessageType* Message) const {
   nodeUUIDToBytes(this, *Message->mutable_uuid());
   Message->set_binary_path(this->BinaryPath);
@@ -41,17 +402,43 @@ void Module::toProtobuf(MessageType* Message) const {
   Message->set_file_format(static_cast<proto::FileFormat>(this->FileFormat));
   Message->set_isa_id(static_cast<proto::ISAID>(this->IsaID));
   Message->set_name(this->Name);
-  this->ImageBytes->toProtobuf(Message->mutable_image_byte_map());
-  *Message->mutable_cfg() = gtirb::toProtobuf(this->Cfg);
-  Message->clear_data();
-  for (const auto& Obj : this->data())
-    Obj.toProtobuf(Message->add_data());
-  Message->clear_sections();
-  for (const auto& Sec : this->sections())
-    Sec.toProtobuf(Message->add_sections());
-  containerToProtobuf(this->Symbols, Message->mutable_symbols());
-  containerToProtobuf(this->SymbolicOperands,
+  const Context& C = getContext();
+  {
+    PhaseTimer Timer(C, "Module::toProtobuf/byteMap");
+    this->ImageBytes->toProtobuf(Message->mutable_image_byte_map());
+    if (Timer.enabled())
+      Timer.setBytes(byteMapBytes(Message->image_byte_map()));
+  }
+  {
+    PhaseTimer Timer(C, "Module::toProtobuf/cfg");
+    Timer.setNodes(num_vertices(*this->Cfg));
+    *Message->mutable_cfg() = gtirb::toProtobuf(*this->Cfg);
+  }
+  {
+    PhaseTimer Timer(C, "Module::toProtobuf/data");
+    Message->clear_data();
+    for (const auto& Obj : this->data())
+      Obj.toProtobuf(Message->add_data());
+    Timer.setNodes(Message->data_size());
+  }
+  {
+    PhaseTimer Timer(C, "Module::toProtobuf/sections");
+    Message->clear_sections();
+    for (const auto& Sec : this->sections())
+      Sec.toProtobuf(Message->add_sections());
+    Timer.setNodes(Message->sections_size());
+  }
+  {
+    PhaseTimer Timer(C, "Module::toProtobuf/symbols");
+    Message->clear_symbols();
+    for (const auto& Sym : this->symbols())
+      Sym.toProtobuf(Message->add_symbols());
+    Timer.setNodes(Message->symbols_size());
+  }
+  PhaseTimer Timer(C, "Module::toProtobuf/symbolicOperands");
+  containerToProtobuf(*this->SymbolicOperands,
                       Message->mutable_symbolic_operands());
+  Timer.setNodes(Message->symbolic_operands_size());
 }
 
 // FIXME: improve containerFromProtobuf so it can handle a pair where one
@@ -77,15 +464,55 @@ Module* Module::fromProtobuf(Context& C, const MessageType& Message) {
   M->FileFormat = static_cast<gtirb::FileFormat>(Message.file_format());
   M->IsaID = static_cast<ISAID>(Message.isa_id());
   M->Name = Message.name();
-  M->ImageBytes = ImageByteMap::fromProtobuf(C, Message.image_byte_map());
-  gtirb::fromProtobuf(C, M->Cfg, Message.cfg());
-  for (const auto& Elt : Message.data())
-    M->addData(DataObject::fromProtobuf(C, Elt));
-  for (const auto& Elt : Message.sections())
-    M->addSection(Section::fromProtobuf(C, Elt));
-  containerFromProtobuf(C, M->Symbols, Message.symbols());
+  {
+    PhaseTimer Timer(C, "Module::fromProtobuf/byteMap");
+    if (Timer.enabled())
+      Timer.setBytes(byteMapBytes(Message.image_byte_map()));
+    M->ImageBytes = ImageByteMap::fromProtobuf(C, Message.image_byte_map());
+  }
+  {
+    PhaseTimer Timer(C, "Module::fromProtobuf/cfg");
+    Timer.setNodes(Message.cfg().blocks_size());
+    gtirb::fromProtobuf(C, M->Cfg.mut(), Message.cfg());
+  }
+  // Build each container with a single bulk insertion.
+  {
+    PhaseTimer Timer(C, "Module::fromProtobuf/data");
+    Timer.setNodes(Message.data_size());
+    std::vector<DataObject*> Data;
+    Data.reserve(Message.data_size());
+    for (const auto& Elt : Message.data())
+      Data.push_back(DataObject::fromProtobuf(C, Elt));
+    M->addData(Data.begin(), Data.end());
+  }
+  {
+    PhaseTimer Timer(C, "Module::fromProtobuf/sections");
+    Timer.setNodes(Message.sections_size());
+    std::vector<Section*> Sections;
+    Sections.reserve(Message.sections_size());
+    for (const auto& Elt : Message.sections())
+      Sections.push_back(Section::fromProtobuf(C, Elt));
+    M->addSection(Sections.begin(), Sections.end());
+  }
+  std::vector<Symbol*> Symbols;
+  {
+    PhaseTimer Timer(C, "Module::fromProtobuf/symbols");
+    Timer.setNodes(Message.symbols_size());
+    Symbols.reserve(Message.symbols_size());
+    for (const auto& Elt : Message.symbols())
+      Symbols.push_back(Symbol::fromProtobuf(C, Elt));
+  }
+  {
+    PhaseTimer Timer(C, "Module::fromProtobuf/symbolIndex");
+    Timer.setNodes(Symbols.size());
+    M->addSymbol(Symbols.begin(), Symbols.end());
+  }
   // Create SymbolicExpressions after the Symbols they reference.
-  containerFromProtobuf(C, M->SymbolicOperands, Message.symbolic_operands());
+  PhaseTimer Timer(C, "Module::fromProtobuf/symbolicOperands");
+  Timer.setNodes(Message.symbolic_operands_size());
+  std::vector<SymbolicExpressionElement> SymbolicOperands;
+  containerFromProtobuf(C, SymbolicOperands, Message.symbolic_operands());
+  M->addSymbolicExpression(SymbolicOperands.begin(), SymbolicOperands.end());
 
   return M;
 }
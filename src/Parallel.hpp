@@ -0,0 +1,80 @@
+//===- Parallel.hpp ---------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PARALLEL_H
+#define GTIRB_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Utilities for running independent work concurrently
+
+namespace gtirb {
+/// \brief Call a function once for each index in [0, Count), spreading the
+/// calls over up to std::thread::hardware_concurrency() threads.
+///
+/// The calling thread takes part in the work. Calls for different indices
+/// may run concurrently, so \p F must be safe to call that way. If any call
+/// throws, the remaining indices are skipped and the first exception is
+/// rethrown once every thread has finished.
+///
+/// \param Count  The number of indices.
+/// \param F      The function to call with each index.
+///
+/// \return void
+template <typename Func> void parallelFor(size_t Count, Func F) {
+  size_t NumThreads = std::min<size_t>(
+      Count, std::max(1u, std::thread::hardware_concurrency()));
+  if (NumThreads <= 1) {
+    for (size_t I = 0; I < Count; ++I)
+      F(I);
+    return;
+  }
+
+  std::atomic<size_t> Next{0};
+  std::atomic<bool> Failed{false};
+  std::exception_ptr Error;
+  std::mutex ErrorMutex;
+  auto Worker = [&]() {
+    for (size_t I = Next++; I < Count && !Failed; I = Next++) {
+      try {
+        F(I);
+      } catch (...) {
+        std::lock_guard<std::mutex> Lock(ErrorMutex);
+        if (!Error)
+          Error = std::current_exception();
+        Failed = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> Threads;
+  Threads.reserve(NumThreads - 1);
+  for (size_t T = 1; T < NumThreads; ++T)
+    Threads.emplace_back(Worker);
+  Worker();
+  for (auto& T : Threads)
+    T.join();
+
+  if (Error)
+    std::rethrow_exception(Error);
+}
+} // namespace gtirb
+
+#endif // GTIRB_PARALLEL_H
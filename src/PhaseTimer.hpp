@@ -0,0 +1,106 @@
+//===- PhaseTimer.hpp -------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PHASE_TIMER_H
+#define GTIRB_PHASE_TIMER_H
+
+#include <gtirb/Context.hpp>
+#include <gtirb/Stats.hpp>
+#include <chrono>
+#include <cstdint>
+
+// Measurement of the phases reported to a StatsSink
+
+namespace gtirb {
+/// \brief Measures a phase from construction to destruction and reports it
+/// to the StatsSink of a Context, if one is installed.
+///
+/// Without a sink, constructing the timer reads no clock and the setters do
+/// nothing. Callers computing counts only for the timer should check \ref
+/// enabled first.
+class PhaseTimer {
+public:
+  PhaseTimer(const Context& C, std::string_view Phase)
+      : Sink(C.getStatsSink()) {
+    if (Sink) {
+      Stats.Phase = Phase;
+      Start = std::chrono::steady_clock::now();
+    }
+  }
+
+  PhaseTimer(const PhaseTimer&) = delete;
+  PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+  ~PhaseTimer() {
+    if (Sink) {
+      Stats.Time = std::chrono::steady_clock::now() - Start;
+      Sink->record(Stats);
+    }
+  }
+
+  /// \brief Whether the phase will be reported.
+  bool enabled() const { return Sink != nullptr; }
+
+  /// \brief Set the number of bytes processed in the phase.
+  void setBytes(uint64_t Bytes) { Stats.Bytes = Bytes; }
+
+  /// \brief Set the number of nodes processed in the phase.
+  void setNodes(uint64_t Nodes) { Stats.Nodes = Nodes; }
+
+private:
+  StatsSink* Sink;
+  PhaseStats Stats;
+  std::chrono::steady_clock::time_point Start;
+};
+
+/// \brief Accumulates the time a Context spends registering and
+/// unregistering node UUIDs, from construction to destruction, and reports
+/// it as one "Context/registerNode" phase, if a StatsSink is installed.
+///
+/// Registration is spread over every node created, so it cannot be timed by
+/// a PhaseTimer around one region. A timer constructed while another is
+/// active does nothing; the outer one reports.
+class RegistrationTimer {
+public:
+  explicit RegistrationTimer(Context& C)
+      : Ctx(C), Active(C.getStatsSink() && !C.TimingRegistration) {
+    if (Active) {
+      Ctx.TimingRegistration = true;
+      Ctx.RegistrationTime = std::chrono::nanoseconds{0};
+      Ctx.Registrations = 0;
+    }
+  }
+
+  RegistrationTimer(const RegistrationTimer&) = delete;
+  RegistrationTimer& operator=(const RegistrationTimer&) = delete;
+
+  ~RegistrationTimer() {
+    if (Active) {
+      Ctx.TimingRegistration = false;
+      PhaseStats Stats;
+      Stats.Phase = "Context/registerNode";
+      Stats.Time = Ctx.RegistrationTime;
+      Stats.Nodes = Ctx.Registrations;
+      if (StatsSink* Sink = Ctx.getStatsSink())
+        Sink->record(Stats);
+    }
+  }
+
+private:
+  Context& Ctx;
+  bool Active;
+};
+} // namespace gtirb
+
+#endif // GTIRB_PHASE_TIMER_H
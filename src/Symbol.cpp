@@ -35,7 +35,7 @@ private:
 void Symbol::toProtobuf(MessageType* Message) const {
   nodeUUIDToBytes(this, *Message->mutable_uuid());
   std::visit(StorePayload(Message), Payload);
-  Message->set_name(this->Name);
+  Message->set_name(*this->Name);
   Message->set_storage_kind(static_cast<proto::StorageKind>(this->Storage));
 }
 
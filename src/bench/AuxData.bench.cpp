@@ -0,0 +1,72 @@
+//===- AuxData.bench.cpp ----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "BenchUtils.hpp"
+#include <proto/AuxData.pb.h>
+
+using namespace gtirb;
+using namespace gtirb::bench;
+
+static void BM_AuxDataEncode(benchmark::State& State) {
+  AuxData Table;
+  Table = makeFunctionTable(State.range(0));
+
+  PeakMemory Peak;
+  size_t Bytes = 0;
+  for (auto _ : State)
+    Bytes = toProtobuf(Table).data().size();
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+  State.SetBytesProcessed(State.iterations() * Bytes);
+  Peak.report(State);
+}
+BENCHMARK(BM_AuxDataEncode)->Apply(sizes);
+
+static void BM_AuxDataDecode(benchmark::State& State) {
+  Context C;
+  AuxData Table;
+  Table = makeFunctionTable(State.range(0));
+  auto Message = toProtobuf(Table);
+
+  PeakMemory Peak;
+  for (auto _ : State) {
+    AuxData Result;
+    fromProtobuf(C, Result, Message);
+    benchmark::DoNotOptimize(Result.get<FunctionTable>());
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+  State.SetBytesProcessed(State.iterations() * Message.data().size());
+  Peak.report(State);
+}
+BENCHMARK(BM_AuxDataDecode)->Apply(sizes);
+
+// Extract the address of every function from a loaded table, then its size,
+// without decoding the rows.
+static void BM_AuxDataColumns(benchmark::State& State) {
+  Context C;
+  AuxData Table;
+  Table = makeFunctionTable(State.range(0));
+  auto Message = toProtobuf(Table);
+
+  PeakMemory Peak;
+  for (auto _ : State) {
+    AuxData Result;
+    fromProtobuf(C, Result, Message);
+    benchmark::DoNotOptimize(Result.column<FunctionTable, 1>());
+    benchmark::DoNotOptimize(Result.column<FunctionTable, 2>());
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+  State.SetBytesProcessed(State.iterations() * Message.data().size());
+  Peak.report(State);
+}
+BENCHMARK(BM_AuxDataColumns)->Apply(sizes);
@@ -0,0 +1,135 @@
+//===- BenchUtils.hpp -------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_BENCH_UTILS_H
+#define GTIRB_BENCH_UTILS_H
+
+#include "SyntheticIR.hpp"
+#include <gtirb/gtirb.hpp>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// Utilities shared by the gtirb-bench benchmarks.
+
+namespace gtirb {
+namespace bench {
+
+/// \brief The "functions" table stored in synthetic IRs.
+using synthetic::FunctionTable;
+
+/// \brief The largest size any benchmark is run at.
+///
+/// Set the GTIRB_BENCH_MAX_SIZE environment variable to change it.
+inline int64_t maxSize() {
+  static const int64_t Max = [] {
+    const char* Value = std::getenv("GTIRB_BENCH_MAX_SIZE");
+    return Value ? std::max<int64_t>(std::atoll(Value), 1) : 1 << 16;
+  }();
+  return Max;
+}
+
+/// \brief Run a benchmark at sizes from 1024 up to \ref maxSize.
+inline void sizes(benchmark::internal::Benchmark* B) {
+  for (int64_t Size = 1 << 10; Size <= maxSize(); Size *= 8)
+    B->Arg(Size);
+}
+
+/// \brief The generator options used for a benchmark of \p Size: one
+/// module of \p Size blocks with the default density of everything else.
+inline synthetic::Options options(int64_t Size) {
+  synthetic::Options Opts;
+  Opts.BlocksPerModule = static_cast<uint64_t>(Size);
+  Opts.AuxDataTables = 0;
+  return Opts;
+}
+
+/// \brief Build a synthetic module with \p Size blocks.
+inline Module* makeModule(Context& C, int64_t Size) {
+  return synthetic::generateModule(C, options(Size));
+}
+
+/// \brief Build a \ref FunctionTable with \p Size rows.
+inline FunctionTable makeFunctionTable(int64_t Size) {
+  FunctionTable Table;
+  Table.reserve(Size);
+  for (int64_t I = 0; I < Size; ++I)
+    Table.emplace_back("function_" + std::to_string(I),
+                       Addr(0x10000 + I * 64), 64);
+  return Table;
+}
+
+/// \brief Build a synthetic IR with one module of \p Size blocks and its
+/// "functions" table.
+inline IR* makeIR(Context& C, int64_t Size,
+                  synthetic::Counts* Counts = nullptr) {
+  return synthetic::generateIR(C, options(Size), Counts);
+}
+
+/// \brief Measures the peak resident set size of the process over part of a
+/// benchmark.
+///
+/// On Linux the peak is reset on construction, so that \ref report gives
+/// the peak reached since. Elsewhere, \ref report gives the peak over the
+/// whole process, as reported by getrusage.
+class PeakMemory {
+public:
+  PeakMemory() {
+#ifdef __linux__
+    // Writing 5 to clear_refs resets the peak RSS of the process.
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+  }
+
+  /// \brief Record the peak as the "peak_rss" counter of \p State.
+  void report(benchmark::State& State) const {
+    State.counters["peak_rss"] = benchmark::Counter(
+        static_cast<double>(peakBytes()), benchmark::Counter::kDefaults,
+        benchmark::Counter::kIs1024);
+  }
+
+private:
+  static int64_t peakBytes() {
+#ifdef __linux__
+    std::ifstream Status("/proc/self/status");
+    std::string Line;
+    while (std::getline(Status, Line))
+      if (Line.compare(0, 6, "VmHWM:") == 0)
+        return std::atoll(Line.c_str() + 6) * 1024;
+#endif
+#ifndef _WIN32
+    struct rusage Usage;
+    if (getrusage(RUSAGE_SELF, &Usage) == 0) {
+#ifdef __APPLE__
+      return Usage.ru_maxrss;
+#else
+      return static_cast<int64_t>(Usage.ru_maxrss) * 1024;
+#endif
+    }
+#endif
+    return 0;
+  }
+};
+
+} // namespace bench
+} // namespace gtirb
+
+#endif // GTIRB_BENCH_UTILS_H
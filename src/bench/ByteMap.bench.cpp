@@ -0,0 +1,57 @@
+//===- ByteMap.bench.cpp ----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "BenchUtils.hpp"
+#include <memory>
+
+using namespace gtirb;
+using namespace gtirb::bench;
+
+// Write Size regions of 64 bytes each, separated by 16-byte gaps.
+static void BM_ByteMapSetData(benchmark::State& State) {
+  std::vector<std::byte> Chunk(64, std::byte(0xcc));
+  PeakMemory Peak;
+  for (auto _ : State) {
+    auto M = std::make_unique<ByteMap>();
+    for (int64_t I = 0; I < State.range(0); ++I)
+      M->setData(Addr(I * 80), Chunk);
+    State.PauseTiming();
+    M.reset();
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+  State.SetBytesProcessed(State.iterations() * State.range(0) * Chunk.size());
+  Peak.report(State);
+}
+BENCHMARK(BM_ByteMapSetData)->Apply(sizes);
+
+// Read every region written by BM_ByteMapSetData.
+static void BM_ByteMapData(benchmark::State& State) {
+  std::vector<std::byte> Chunk(64, std::byte(0xcc));
+  ByteMap M;
+  for (int64_t I = 0; I < State.range(0); ++I)
+    M.setData(Addr(I * 80), Chunk);
+
+  PeakMemory Peak;
+  for (auto _ : State) {
+    for (int64_t I = 0; I < State.range(0); ++I) {
+      auto Data = M.data(Addr(I * 80), Chunk.size());
+      benchmark::DoNotOptimize(*Data.begin());
+    }
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+  State.SetBytesProcessed(State.iterations() * State.range(0) * Chunk.size());
+  Peak.report(State);
+}
+BENCHMARK(BM_ByteMapData)->Apply(sizes);
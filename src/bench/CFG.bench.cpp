@@ -0,0 +1,75 @@
+//===- CFG.bench.cpp --------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "BenchUtils.hpp"
+
+using namespace gtirb;
+using namespace gtirb::bench;
+
+// Visit every edge of the CFG, from its source block.
+static void BM_CFGTraversal(benchmark::State& State) {
+  Context C;
+  Module* M = makeModule(C, State.range(0));
+  const CFG& Cfg = M->readCFG();
+
+  PeakMemory Peak;
+  for (auto _ : State) {
+    uint64_t Sum = 0;
+    for (auto V : boost::make_iterator_range(vertices(Cfg)))
+      for (auto E : boost::make_iterator_range(out_edges(V, Cfg)))
+        Sum += static_cast<uint64_t>(Cfg[target(E, Cfg)]->getAddress());
+    benchmark::DoNotOptimize(Sum);
+  }
+  State.SetItemsProcessed(State.iterations() * num_edges(Cfg));
+  Peak.report(State);
+}
+BENCHMARK(BM_CFGTraversal)->Apply(sizes);
+
+// Count the call blocks in the lower half of the address space of a module,
+// by walking the CFG.
+static void BM_FindCallBlocksCFG(benchmark::State& State) {
+  Context C;
+  Module* M = makeModule(C, State.range(0));
+  const CFG& Cfg = M->readCFG();
+  auto Addrs = M->blockColumns().addresses();
+  Addr Upper = Addrs[Addrs.size() / 2];
+
+  PeakMemory Peak;
+  for (auto _ : State) {
+    uint64_t Count = 0;
+    for (const auto& B : blocks(Cfg))
+      Count += B.getAddress() < Upper &&
+               B.getExitKind() == Block::Exit::Call;
+    benchmark::DoNotOptimize(Count);
+  }
+  State.SetItemsProcessed(State.iterations() * num_vertices(Cfg));
+  Peak.report(State);
+}
+BENCHMARK(BM_FindCallBlocksCFG)->Apply(sizes);
+
+// As BM_FindCallBlocksCFG, but scanning the module's BlockColumns.
+static void BM_FindCallBlocksColumns(benchmark::State& State) {
+  Context C;
+  Module* M = makeModule(C, State.range(0));
+  const BlockColumns& Columns = M->blockColumns();
+  Addr Upper = Columns.addresses()[Columns.size() / 2];
+
+  PeakMemory Peak;
+  for (auto _ : State)
+    benchmark::DoNotOptimize(
+        Columns.findBlocks(Columns.addresses()[0], Upper, Block::Exit::Call));
+  State.SetItemsProcessed(State.iterations() * Columns.size());
+  Peak.report(State);
+}
+BENCHMARK(BM_FindCallBlocksColumns)->Apply(sizes);
@@ -0,0 +1,62 @@
+//===- IR.bench.cpp ---------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "BenchUtils.hpp"
+#include <memory>
+#include <sstream>
+
+using namespace gtirb;
+using namespace gtirb::bench;
+
+static void BM_IRSave(benchmark::State& State) {
+  Context C;
+  synthetic::Counts Counts;
+  IR* I = makeIR(C, State.range(0), &Counts);
+  PeakMemory Peak;
+  size_t Bytes = 0;
+  for (auto _ : State) {
+    std::ostringstream Out;
+    I->save(Out);
+    Bytes = Out.tellp();
+  }
+  State.SetItemsProcessed(State.iterations() * Counts.nodes());
+  State.SetBytesProcessed(State.iterations() * Bytes);
+  Peak.report(State);
+}
+BENCHMARK(BM_IRSave)->Apply(sizes)->Unit(benchmark::kMillisecond);
+
+static void BM_IRLoad(benchmark::State& State) {
+  std::string Serialized;
+  synthetic::Counts Counts;
+  {
+    Context C;
+    std::ostringstream Out;
+    makeIR(C, State.range(0), &Counts)->save(Out);
+    Serialized = Out.str();
+  }
+
+  PeakMemory Peak;
+  for (auto _ : State) {
+    auto C = std::make_unique<Context>();
+    std::istringstream In(Serialized);
+    benchmark::DoNotOptimize(IR::load(*C, In));
+    State.PauseTiming();
+    C.reset();
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(State.iterations() * Counts.nodes());
+  State.SetBytesProcessed(State.iterations() * Serialized.size());
+  Peak.report(State);
+}
+BENCHMARK(BM_IRLoad)->Apply(sizes)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,67 @@
+//===- Module.bench.cpp -----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "BenchUtils.hpp"
+
+using namespace gtirb;
+using namespace gtirb::bench;
+
+static void BM_FindSymbolsByName(benchmark::State& State) {
+  Context C;
+  Module* M = makeModule(C, State.range(0));
+  std::vector<std::string> Names;
+  for (const auto& S : M->symbols())
+    Names.push_back(S.getName());
+
+  PeakMemory Peak;
+  for (auto _ : State)
+    for (const auto& N : Names)
+      benchmark::DoNotOptimize(M->findSymbols(N).begin());
+  State.SetItemsProcessed(State.iterations() * Names.size());
+  Peak.report(State);
+}
+BENCHMARK(BM_FindSymbolsByName)->Apply(sizes);
+
+static void BM_FindSymbolsByAddr(benchmark::State& State) {
+  Context C;
+  Module* M = makeModule(C, State.range(0));
+  std::vector<Addr> Addrs;
+  for (const auto& B : blocks(M->readCFG()))
+    Addrs.push_back(B.getAddress());
+
+  PeakMemory Peak;
+  for (auto _ : State)
+    for (Addr A : Addrs)
+      benchmark::DoNotOptimize(M->findSymbols(A).begin());
+  State.SetItemsProcessed(State.iterations() * Addrs.size());
+  Peak.report(State);
+}
+BENCHMARK(BM_FindSymbolsByAddr)->Apply(sizes);
+
+static void BM_FindData(benchmark::State& State) {
+  Context C;
+  Module* M = makeModule(C, State.range(0));
+  // Look up an address inside each data object.
+  std::vector<Addr> Addrs;
+  for (const auto& D : M->data())
+    Addrs.push_back(D.getAddress() + 3);
+
+  PeakMemory Peak;
+  for (auto _ : State)
+    for (Addr A : Addrs)
+      benchmark::DoNotOptimize(M->findData(A).begin());
+  State.SetItemsProcessed(State.iterations() * Addrs.size());
+  Peak.report(State);
+}
+BENCHMARK(BM_FindData)->Apply(sizes);
@@ -0,0 +1,249 @@
+//===- SyntheticIR.cpp ------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "SyntheticIR.hpp"
+#include <gtirb/gtirb.hpp>
+#include <algorithm>
+#include <utility>
+
+using namespace gtirb;
+using namespace gtirb::synthetic;
+
+namespace {
+// A SplitMix64 generator. Unlike the standard distributions, its results do
+// not depend on the standard library, so generated IR is reproducible
+// everywhere.
+class Random {
+public:
+  explicit Random(uint64_t Seed) : State(Seed) {}
+
+  uint64_t next() {
+    uint64_t Z = (State += 0x9e3779b97f4a7c15);
+    Z = (Z ^ (Z >> 30)) * 0xbf58476d1ce4e5b9;
+    Z = (Z ^ (Z >> 27)) * 0x94d049bb133111eb;
+    return Z ^ (Z >> 31);
+  }
+
+  // A value in [0, N), or 0 if N is 0.
+  uint64_t below(uint64_t N) { return N == 0 ? 0 : next() % N; }
+
+  // A value in [Lower, Upper].
+  uint64_t between(uint64_t Lower, uint64_t Upper) {
+    return Lower + below(Upper - Lower + 1);
+  }
+
+  bool chance(double P) { return (next() >> 11) * 0x1.0p-53 < P; }
+
+  // Realize an average count: its whole part, plus one with the probability
+  // of its fractional part.
+  uint64_t count(double Mean) {
+    if (Mean <= 0)
+      return 0;
+    auto Whole = static_cast<uint64_t>(Mean);
+    return Whole + (chance(Mean - static_cast<double>(Whole)) ? 1 : 0);
+  }
+
+private:
+  uint64_t State;
+};
+
+// Unused address space between regions of a module.
+constexpr uint64_t RegionGap = 0x1000;
+} // namespace
+
+Module* gtirb::synthetic::generateModule(Context& C, const Options& Opts,
+                                         uint64_t Index, Counts* Result,
+                                         FunctionTable* Functions) {
+  Random Rng(Opts.Seed ^ ((Index + 1) * 0xd1b54a32d192ed03));
+  std::string Suffix = std::to_string(Index);
+  auto* M = Module::Create(C);
+  M->setName("synthetic" + Suffix);
+  auto& Cfg = M->getCFG();
+
+  const uint64_t NumBlocks = Opts.BlocksPerModule;
+  const uint64_t MinSize = std::max<uint64_t>(Opts.MinBlockSize, 4);
+  const uint64_t MaxSize = std::max(Opts.MaxBlockSize, MinSize);
+  const uint64_t PerFunction = std::max<uint64_t>(Opts.BlocksPerFunction, 1);
+  const uint64_t NumFunctions = (NumBlocks + PerFunction - 1) / PerFunction;
+  const uint64_t NumRegions =
+      std::max<uint64_t>(std::min(Opts.ByteMapRegions, NumBlocks), 1);
+  const uint64_t PerRegion = (NumBlocks + NumRegions - 1) / NumRegions;
+
+  // Lay out the blocks, starting a new region every PerRegion blocks. Each
+  // block but the last of a function falls through to the next and may
+  // branch within its function; any block may call the entry of a function.
+  const Addr Base((Index + 1) << 40);
+  std::vector<std::pair<Addr, uint64_t>> Regions;
+  std::vector<Block*> Blocks;
+  Blocks.reserve(NumBlocks);
+  std::vector<uint64_t> Branches(NumBlocks);
+  std::vector<bool> Calls(NumBlocks);
+  Addr Next = Base;
+  for (uint64_t I = 0; I < NumBlocks; ++I) {
+    if (I % PerRegion == 0) {
+      if (!Regions.empty())
+        Next += RegionGap;
+      Regions.emplace_back(Next, 0);
+    }
+    uint64_t Size = Rng.between(MinSize, MaxSize);
+    bool LastInFunction =
+        I % PerFunction == PerFunction - 1 || I + 1 == NumBlocks;
+    Branches[I] = LastInFunction ? 0 : Rng.count(Opts.FanOut - 1);
+    Calls[I] = Rng.chance(Opts.CallDensity);
+
+    Block::Exit ExitKind = Block::Exit::Fallthrough;
+    if (Calls[I])
+      ExitKind = Block::Exit::Call;
+    else if (LastInFunction)
+      ExitKind = Block::Exit::Return;
+    else if (Branches[I] > 0)
+      ExitKind = Block::Exit::Branch;
+    Blocks.push_back(emplaceBlock(Cfg, C, Next, Size, ExitKind));
+    Next += Size;
+    Regions.back().second += Size;
+  }
+
+  // Connect the blocks.
+  uint64_t NumEdges = 0;
+  for (uint64_t I = 0; I < NumBlocks; ++I) {
+    uint64_t FunctionBegin = I - I % PerFunction;
+    uint64_t FunctionEnd = std::min(FunctionBegin + PerFunction, NumBlocks);
+    if (I + 1 < FunctionEnd) {
+      auto Fallthrough = addEdge(Blocks[I], Blocks[I + 1], Cfg);
+      ++NumEdges;
+      if (Branches[I] > 0)
+        Cfg[Fallthrough] = false;
+      for (uint64_t E = 0; E < Branches[I]; ++E) {
+        uint64_t Target =
+            Rng.chance(Opts.LoopFraction)
+                ? Rng.between(FunctionBegin, I)
+                : Rng.between(I + 1, FunctionEnd - 1);
+        Cfg[addEdge(Blocks[I], Blocks[Target], Cfg)] = true;
+        ++NumEdges;
+      }
+    }
+    if (Calls[I]) {
+      uint64_t Callee = Rng.below(NumFunctions) * PerFunction;
+      addEdge(Blocks[I], Blocks[Callee], Cfg);
+      ++NumEdges;
+    }
+  }
+
+  // Name each function, and add further symbols for random blocks.
+  std::vector<Symbol*> Symbols;
+  for (uint64_t F = 0; F < NumFunctions; ++F) {
+    uint64_t Entry = F * PerFunction;
+    uint64_t End = std::min(Entry + PerFunction, NumBlocks);
+    std::string Name = "f" + Suffix + "_" + std::to_string(F);
+    Symbols.push_back(Symbol::Create(C, Blocks[Entry], Name));
+    if (Functions) {
+      Addr Last = addressLimit(*Blocks[End - 1]);
+      Addr Start = Blocks[Entry]->getAddress();
+      Functions->emplace_back(Name, Start, static_cast<uint64_t>(Last - Start));
+    }
+  }
+  for (uint64_t I = 0; I < NumBlocks; ++I) {
+    for (uint64_t K = Rng.count(Opts.SymbolsPerBlock); K > 0; --K) {
+      std::string Name = "l" + Suffix + "_" + std::to_string(Symbols.size());
+      Symbols.push_back(Symbol::Create(C, Blocks[I], Name));
+    }
+  }
+
+  // Data objects, each with a symbol, follow the blocks in a region of their
+  // own.
+  std::vector<DataObject*> Data;
+  Next += RegionGap;
+  Regions.emplace_back(Next, 0);
+  for (uint64_t I = 0; I < NumBlocks; ++I) {
+    for (uint64_t K = Rng.count(Opts.DataPerBlock); K > 0; --K) {
+      uint64_t Size = 8 * Rng.between(1, 4);
+      auto* D = DataObject::Create(C, Next, Size);
+      Data.push_back(D);
+      std::string Name = "d" + Suffix + "_" + std::to_string(Data.size() - 1);
+      Symbols.push_back(Symbol::Create(C, D, Name));
+      Next += Size;
+      Regions.back().second += Size;
+    }
+  }
+
+  // Symbolic operands at distinct offsets within each block, referring to
+  // random symbols.
+  std::vector<std::pair<Addr, SymbolicExpression>> Operands;
+  for (Block* B : Blocks) {
+    uint64_t Count =
+        std::min(Rng.count(Opts.SymbolicOperandsPerBlock), B->getSize() - 1);
+    for (uint64_t K = 0; K < Count; ++K) {
+      Symbol* S = Symbols[Rng.below(Symbols.size())];
+      auto Offset = static_cast<int64_t>(Rng.below(16));
+      Operands.emplace_back(B->getAddress() + 1 + K, SymAddrConst{Offset, S});
+    }
+  }
+
+  // Contents and sections.
+  auto& IBM = M->getImageByteMap();
+  IBM.setBaseAddress(Base);
+  IBM.setAddrMinMax({Base, Next});
+  if (!Blocks.empty())
+    IBM.setEntryPointAddress(Blocks.front()->getAddress());
+  std::vector<Section*> Sections;
+  std::vector<std::byte> Bytes;
+  uint64_t NumBytes = 0;
+  for (size_t R = 0; R < Regions.size(); ++R) {
+    const auto& [Start, Size] = Regions[R];
+    if (Size == 0)
+      continue;
+    Bytes.resize(Size);
+    for (auto& Byte : Bytes)
+      Byte = static_cast<std::byte>(Rng.next());
+    IBM.setData(Start, gsl::span<const std::byte>(Bytes));
+    NumBytes += Size;
+    bool IsData = R + 1 == Regions.size();
+    std::string Name = IsData ? ".data" : ".text" + std::to_string(R);
+    Sections.push_back(Section::Create(C, Name, Start, Size));
+  }
+
+  M->addSection(Sections.begin(), Sections.end());
+  M->addData(Data.begin(), Data.end());
+  M->addSymbol(Symbols.begin(), Symbols.end());
+  M->addSymbolicExpression(Operands.begin(), Operands.end());
+
+  if (Result) {
+    Result->Modules += 1;
+    Result->Blocks += NumBlocks;
+    Result->Edges += NumEdges;
+    Result->Symbols += Symbols.size();
+    Result->DataObjects += Data.size();
+    Result->SymbolicOperands += Operands.size();
+    Result->Bytes += NumBytes;
+  }
+  return M;
+}
+
+IR* gtirb::synthetic::generateIR(Context& C, const Options& Opts,
+                                 Counts* Result) {
+  auto* I = IR::Create(C);
+  FunctionTable Functions;
+  for (uint64_t Index = 0; Index < Opts.Modules; ++Index)
+    I->addModule(generateModule(C, Opts, Index, Result, &Functions));
+  I->addAuxData("functions", std::move(Functions));
+
+  Random Rng(Opts.Seed);
+  for (uint64_t T = 0; T < Opts.AuxDataTables; ++T) {
+    ExtraTable Table;
+    while (Table.size() < Opts.AuxDataRows)
+      Table.emplace(Addr(Rng.next()), Rng.next());
+    I->addAuxData("synthetic" + std::to_string(T), std::move(Table));
+  }
+  return I;
+}
@@ -0,0 +1,143 @@
+//===- SyntheticIR.hpp ------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_SYNTHETIC_IR_H
+#define GTIRB_SYNTHETIC_IR_H
+
+#include <gtirb/Addr.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Generation of synthetic IR for stress and performance testing.
+
+namespace gtirb {
+class Context;
+class IR;
+class Module;
+
+namespace synthetic {
+
+/// \brief The type of the "functions" AuxData table of a synthetic IR: the
+/// name, entry address and size in bytes of each function.
+using FunctionTable = std::vector<std::tuple<std::string, Addr, uint64_t>>;
+
+/// \brief The type of the extra AuxData tables of a synthetic IR.
+using ExtraTable = std::map<Addr, uint64_t>;
+
+/// \brief Parameters of a synthetic IR.
+///
+/// Counts given per block are averages; fractional parts are realized
+/// randomly. All randomness is drawn from a generator seeded with \ref Seed
+/// and does not depend on the standard library implementation, so the same
+/// options always produce the same IR, apart from UUIDs.
+struct Options {
+  /// \brief Seed for all random choices.
+  uint64_t Seed = 0;
+
+  /// \brief Number of modules in the IR.
+  uint64_t Modules = 1;
+  /// \brief Number of blocks in each module.
+  uint64_t BlocksPerModule = 1024;
+  /// \brief Smallest block size, in bytes. At least 4.
+  uint64_t MinBlockSize = 4;
+  /// \brief Largest block size, in bytes.
+  uint64_t MaxBlockSize = 32;
+
+  /// \brief Number of consecutive blocks in each function.
+  uint64_t BlocksPerFunction = 16;
+  /// \brief Average number of intraprocedural successors of each block,
+  /// including the fallthrough to the next block.
+  double FanOut = 1.5;
+  /// \brief Probability that an extra successor is a backward edge (a loop)
+  /// rather than a forward edge.
+  double LoopFraction = 0.25;
+  /// \brief Probability that a block ends in a call, with an edge to the
+  /// entry block of a random function.
+  double CallDensity = 0.1;
+
+  /// \brief Average number of symbols referring to each block, in addition
+  /// to the symbol naming each function.
+  double SymbolsPerBlock = 0.5;
+  /// \brief Average number of data objects per block. Each data object has
+  /// a symbol referring to it.
+  double DataPerBlock = 0.25;
+  /// \brief Average number of symbolic operands in each block.
+  double SymbolicOperandsPerBlock = 1.0;
+
+  /// \brief Number of disjoint regions the blocks of each module are split
+  /// into. Each is a separate section and ByteMap region, and the data
+  /// objects follow in one more.
+  uint64_t ByteMapRegions = 1;
+
+  /// \brief Number of extra AuxData tables attached to the IR, named
+  /// "synthetic0", "synthetic1", ..., each an \ref ExtraTable.
+  uint64_t AuxDataTables = 1;
+  /// \brief Number of rows in each extra AuxData table.
+  uint64_t AuxDataRows = 1024;
+};
+
+/// \brief Summary of the contents of a generated IR.
+struct Counts {
+  uint64_t Modules = 0;
+  uint64_t Blocks = 0;
+  uint64_t Edges = 0;
+  uint64_t Symbols = 0;
+  uint64_t DataObjects = 0;
+  uint64_t SymbolicOperands = 0;
+  uint64_t Bytes = 0;
+
+  /// \brief The number of nodes created: modules, blocks, symbols and data
+  /// objects.
+  uint64_t nodes() const { return Modules + Blocks + Symbols + DataObjects; }
+};
+
+/// \brief Build a synthetic IR through the public API.
+///
+/// Each module holds \ref Options::BlocksPerModule blocks laid out in
+/// address order and grouped into functions, followed by its data objects.
+/// The functions of all modules are listed in a "functions" AuxData table.
+///
+/// \param C       The Context in which to create the IR.
+/// \param Opts    The parameters of the IR.
+/// \param[out] Result  If not null, receives the counts of what was
+///                     generated.
+///
+/// \return The new IR.
+IR* generateIR(Context& C, const Options& Opts, Counts* Result = nullptr);
+
+/// \brief Build one synthetic module, as \ref generateIR does.
+///
+/// \param C       The Context in which to create the module.
+/// \param Opts    The parameters of the module. Options::Modules and the
+///                AuxData table options are ignored.
+/// \param Index   Distinguishes the module from others generated with the
+///                same options: it selects the random stream, base address
+///                and names of the module.
+/// \param[out] Result  If not null, the counts of what was generated are
+///                     added to it.
+/// \param[out] Functions  If not null, the functions of the module are
+///                        appended to it.
+///
+/// \return The new module.
+Module* generateModule(Context& C, const Options& Opts, uint64_t Index = 0,
+                       Counts* Result = nullptr,
+                       FunctionTable* Functions = nullptr);
+
+} // namespace synthetic
+} // namespace gtirb
+
+#endif // GTIRB_SYNTHETIC_IR_H
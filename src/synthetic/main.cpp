@@ -0,0 +1,146 @@
+//===- main.cpp -------------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "SyntheticIR.hpp"
+#include <gtirb/gtirb.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Writes a synthetic IR to a file:
+//
+//   gtirb-synth [--name=value ...] output.gtirb
+//
+// See usage() for the options, each of which sets the Options field of the
+// same name.
+
+using namespace gtirb;
+
+namespace {
+void usage(std::ostream& Out) {
+  Out << "usage: gtirb-synth [options] <output>\n"
+         "options:\n"
+         "  --seed=N                  seed for all random choices\n"
+         "  --modules=N               number of modules\n"
+         "  --blocks=N                blocks per module\n"
+         "  --min-block-size=N        smallest block size in bytes\n"
+         "  --max-block-size=N        largest block size in bytes\n"
+         "  --blocks-per-function=N   blocks per function\n"
+         "  --fan-out=X               average successors per block\n"
+         "  --loop-fraction=X         fraction of branches that loop\n"
+         "  --call-density=X          probability a block ends in a call\n"
+         "  --symbols-per-block=X     average extra symbols per block\n"
+         "  --data-per-block=X        average data objects per block\n"
+         "  --operands-per-block=X    average symbolic operands per block\n"
+         "  --regions=N               ByteMap regions per module\n"
+         "  --aux-tables=N            extra AuxData tables\n"
+         "  --aux-rows=N              rows in each extra AuxData table\n";
+}
+
+bool parseOption(const std::string& Arg, synthetic::Options& Opts) {
+  auto Eq = Arg.find('=');
+  if (Arg.compare(0, 2, "--") != 0 || Eq == std::string::npos)
+    return false;
+  std::string Name = Arg.substr(2, Eq - 2);
+  const char* Value = Arg.c_str() + Eq + 1;
+  char* End = nullptr;
+
+  auto Integer = [&](uint64_t& Field) {
+    Field = std::strtoull(Value, &End, 0);
+  };
+  auto Real = [&](double& Field) { Field = std::strtod(Value, &End); };
+
+  if (Name == "seed")
+    Integer(Opts.Seed);
+  else if (Name == "modules")
+    Integer(Opts.Modules);
+  else if (Name == "blocks")
+    Integer(Opts.BlocksPerModule);
+  else if (Name == "min-block-size")
+    Integer(Opts.MinBlockSize);
+  else if (Name == "max-block-size")
+    Integer(Opts.MaxBlockSize);
+  else if (Name == "blocks-per-function")
+    Integer(Opts.BlocksPerFunction);
+  else if (Name == "fan-out")
+    Real(Opts.FanOut);
+  else if (Name == "loop-fraction")
+    Real(Opts.LoopFraction);
+  else if (Name == "call-density")
+    Real(Opts.CallDensity);
+  else if (Name == "symbols-per-block")
+    Real(Opts.SymbolsPerBlock);
+  else if (Name == "data-per-block")
+    Real(Opts.DataPerBlock);
+  else if (Name == "operands-per-block")
+    Real(Opts.SymbolicOperandsPerBlock);
+  else if (Name == "regions")
+    Integer(Opts.ByteMapRegions);
+  else if (Name == "aux-tables")
+    Integer(Opts.AuxDataTables);
+  else if (Name == "aux-rows")
+    Integer(Opts.AuxDataRows);
+  else
+    return false;
+  return End != Value && *End == '\0';
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  synthetic::Options Opts;
+  std::string Output;
+  for (int I = 1; I < argc; ++I) {
+    std::string Arg = argv[I];
+    if (Arg == "--help" || Arg == "-h") {
+      usage(std::cout);
+      return EXIT_SUCCESS;
+    }
+    if (Arg.compare(0, 2, "--") == 0) {
+      if (!parseOption(Arg, Opts)) {
+        std::cerr << "gtirb-synth: invalid option '" << Arg << "'\n";
+        usage(std::cerr);
+        return EXIT_FAILURE;
+      }
+    } else if (Output.empty()) {
+      Output = Arg;
+    } else {
+      usage(std::cerr);
+      return EXIT_FAILURE;
+    }
+  }
+  if (Output.empty()) {
+    usage(std::cerr);
+    return EXIT_FAILURE;
+  }
+
+  Context C;
+  synthetic::Counts Counts;
+  IR* I = synthetic::generateIR(C, Opts, &Counts);
+  std::ofstream Out(Output, std::ios::out | std::ios::binary);
+  I->save(Out);
+  if (!Out) {
+    std::cerr << "gtirb-synth: cannot write '" << Output << "'\n";
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "modules:           " << Counts.Modules << "\n"
+            << "blocks:            " << Counts.Blocks << "\n"
+            << "edges:             " << Counts.Edges << "\n"
+            << "symbols:           " << Counts.Symbols << "\n"
+            << "data objects:      " << Counts.DataObjects << "\n"
+            << "symbolic operands: " << Counts.SymbolicOperands << "\n"
+            << "bytes:             " << Counts.Bytes << "\n";
+  return EXIT_SUCCESS;
+}
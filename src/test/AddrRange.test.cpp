@@ -0,0 +1,142 @@
+//===- AddrRange.test.cpp ---------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include <gtirb/AddrRange.hpp>
+#include <gtirb/Context.hpp>
+#include <gtirb/DataObject.hpp>
+#include <gtirb/ImageByteMap.hpp>
+#include <gtirb/Module.hpp>
+#include <gtirb/Section.hpp>
+#include <gtest/gtest.h>
+
+using namespace gtirb;
+
+static AddrRange range(uint64_t Lower, uint64_t Upper) {
+  return AddrRange(Addr(Lower), Addr(Upper));
+}
+
+TEST(Unit_AddrRange, range) {
+  AddrRange R = range(10, 20);
+  EXPECT_EQ(R.size(), 10);
+  EXPECT_FALSE(R.empty());
+  EXPECT_TRUE(R.contains(Addr(10)));
+  EXPECT_TRUE(R.contains(Addr(19)));
+  EXPECT_FALSE(R.contains(Addr(20)));
+  EXPECT_TRUE(R.contains(range(12, 20)));
+  EXPECT_FALSE(R.contains(range(12, 21)));
+  EXPECT_TRUE(R.contains(AddrRange()));
+
+  EXPECT_TRUE(R.overlaps(range(19, 30)));
+  EXPECT_FALSE(R.overlaps(range(20, 30)));
+  EXPECT_FALSE(R.overlaps(range(15, 15)));
+  EXPECT_EQ(R.intersection(range(15, 30)), range(15, 20));
+  EXPECT_TRUE(R.intersection(range(25, 30)).empty());
+
+  // An inverted range is empty.
+  EXPECT_TRUE(range(20, 10).empty());
+  EXPECT_TRUE(range(1, 2) < range(1, 3));
+  EXPECT_TRUE(range(1, 3) < range(2, 3));
+
+  Context Ctx;
+  EXPECT_EQ(addressRange(*DataObject::Create(Ctx, Addr(8), 4)), range(8, 12));
+}
+
+TEST(Unit_AddrRange, setCoalesces) {
+  AddrRangeSet S{range(30, 40), range(10, 20), range(15, 25), range(25, 26),
+                 range(50, 50)};
+  ASSERT_EQ(S.ranges().size(), 2);
+  EXPECT_EQ(S.ranges()[0], range(10, 26));
+  EXPECT_EQ(S.ranges()[1], range(30, 40));
+  EXPECT_EQ(S.size(), 26);
+  EXPECT_TRUE(AddrRangeSet().empty());
+
+  S.insert(range(26, 30));
+  ASSERT_EQ(S.ranges().size(), 1);
+  EXPECT_EQ(S.ranges()[0], range(10, 40));
+
+  S.insert(range(0, 5));
+  S.insert(range(60, 70));
+  S.insert(range(45, 46));
+  EXPECT_EQ(S, AddrRangeSet({range(0, 5), range(10, 40), range(45, 46),
+                             range(60, 70)}));
+  S.insert(range(3, 65));
+  EXPECT_EQ(S, AddrRangeSet({range(0, 70)}));
+}
+
+TEST(Unit_AddrRange, setQueries) {
+  AddrRangeSet S{range(10, 20), range(30, 40)};
+  EXPECT_TRUE(S.contains(Addr(10)));
+  EXPECT_FALSE(S.contains(Addr(20)));
+  EXPECT_FALSE(S.contains(Addr(5)));
+  EXPECT_FALSE(S.contains(Addr(45)));
+  ASSERT_NE(S.find(Addr(35)), nullptr);
+  EXPECT_EQ(*S.find(Addr(35)), range(30, 40));
+  EXPECT_TRUE(S.contains(range(31, 40)));
+  EXPECT_FALSE(S.contains(range(15, 35)));
+  EXPECT_TRUE(S.overlaps(range(15, 35)));
+  EXPECT_TRUE(S.overlaps(range(0, 11)));
+  EXPECT_FALSE(S.overlaps(range(20, 30)));
+  EXPECT_FALSE(S.overlaps(range(40, 50)));
+}
+
+TEST(Unit_AddrRange, setOperations) {
+  AddrRangeSet A{range(0, 10), range(20, 30), range(40, 50)};
+  AddrRangeSet B{range(5, 25), range(30, 35), range(45, 46)};
+
+  EXPECT_EQ(A | B, AddrRangeSet({range(0, 35), range(40, 50)}));
+  EXPECT_EQ(A & B, AddrRangeSet({range(5, 10), range(20, 25), range(45, 46)}));
+  EXPECT_EQ(A - B, AddrRangeSet({range(0, 5), range(25, 30), range(40, 45),
+                                 range(46, 50)}));
+  EXPECT_EQ(B - A, AddrRangeSet({range(10, 20), range(30, 35)}));
+  EXPECT_TRUE((A - A).empty());
+  EXPECT_EQ(A | AddrRangeSet(), A);
+  EXPECT_TRUE((A & AddrRangeSet()).empty());
+}
+
+TEST(Unit_AddrRange, batchedLookup) {
+  AddrRangeSet S{range(10, 20), range(30, 40)};
+  std::vector<Addr> Sorted{Addr(0),  Addr(10), Addr(19), Addr(20),
+                           Addr(35), Addr(40), Addr(50)};
+  EXPECT_EQ(S.findContained(Sorted), std::vector<size_t>({1, 2, 4}));
+  EXPECT_EQ(S.countContained(Sorted), 3);
+
+  std::vector<Addr> Unsorted{Addr(35), Addr(0), Addr(19), Addr(40),
+                             Addr(10)};
+  EXPECT_EQ(S.findContained(Unsorted), std::vector<size_t>({0, 2, 4}));
+  EXPECT_EQ(S.countContained(Unsorted), 3);
+
+  EXPECT_TRUE(AddrRangeSet().findContained(Sorted).empty());
+  EXPECT_EQ(S.countContained({}), 0);
+}
+
+TEST(Unit_AddrRange, fromObjects) {
+  Context Ctx;
+  auto* M = Module::Create(Ctx);
+  M->addSection(Section::Create(Ctx, ".b", Addr(100), 10));
+  M->addSection(Section::Create(Ctx, ".a", Addr(10), 10));
+  M->addSection(Section::Create(Ctx, ".c", Addr(110), 5));
+  EXPECT_EQ(AddrRangeSet::of(M->sections()),
+            AddrRangeSet({range(10, 20), range(100, 115)}));
+
+  std::vector<DataObject*> Data{DataObject::Create(Ctx, Addr(4), 4),
+                                DataObject::Create(Ctx, Addr(0), 2)};
+  EXPECT_EQ(AddrRangeSet::of(Data), AddrRangeSet({range(0, 2), range(4, 8)}));
+
+  auto& IBM = M->getImageByteMap();
+  IBM.setAddrMinMax({Addr(0), Addr(1000)});
+  IBM.setData(Addr(10), 10, std::byte(0));
+  IBM.setData(Addr(100), 15, std::byte(0));
+  EXPECT_EQ(IBM.addressRanges(), AddrRangeSet::of(M->sections()));
+  EXPECT_TRUE((AddrRangeSet::of(M->sections()) - IBM.addressRanges()).empty());
+}
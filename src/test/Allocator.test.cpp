@@ -16,6 +16,7 @@
 #include <gtirb/Allocator.hpp>
 #include <array>
 #include <gtest/gtest.h>
+#include <vector>
 
 class AllocTest {
 public:
@@ -59,3 +60,29 @@ TEST(Unit_Allocator, deallocate) {
     EXPECT_EQ(AllocTest::DtorCount, AllocTest::CtorCount);
   }
 }
+
+TEST(Unit_Allocator, absorb) {
+  AllocTest::CtorCount = AllocTest::DtorCount = 0;
+  {
+    Allocator A;
+    std::vector<AllocTest*> Objects;
+    {
+      Allocator B;
+      // Enough objects for several slabs, the last partly used.
+      for (int I = 0; I < 2000; ++I)
+        Objects.push_back(new (B) AllocTest);
+      new (A) AllocTest;
+      A.absorb(B);
+    }
+    // B's objects now belong to A, and A can still allocate.
+    EXPECT_EQ(AllocTest::DtorCount, 0);
+    for (auto* Object : Objects)
+      Object->Data.fill('x');
+    new (A) AllocTest;
+
+    Allocator Empty;
+    A.absorb(Empty);
+  }
+  EXPECT_EQ(AllocTest::CtorCount, 2002);
+  EXPECT_EQ(AllocTest::DtorCount, 2002);
+}
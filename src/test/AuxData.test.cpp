@@ -13,6 +13,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include <gtirb/AuxData.hpp>
+#include <gtirb/AuxDataTypeRegistry.hpp>
 #include <gtirb/Context.hpp>
 #include <proto/AuxData.pb.h>
 #include <gtest/gtest.h>
@@ -152,6 +153,15 @@ TEST(Unit_AuxData, typeNameImpl) {
 
   X = AuxDataTemplate<std::vector<std::tuple<int64_t, uint64_t>>>().typeName();
   EXPECT_EQ(X, "sequence<tuple<int64_t,uint64_t>>");
+
+  X = AuxDataTemplate<std::set<Addr>>().typeName();
+  EXPECT_EQ(X, "set<Addr>");
+
+  X = AuxDataTemplate<std::unordered_multimap<Addr, std::string>>().typeName();
+  EXPECT_EQ(X, "multimapping<Addr,string>");
+
+  X = AuxDataTemplate<std::optional<std::variant<Addr, int64_t>>>().typeName();
+  EXPECT_EQ(X, "option<variant<Addr,int64_t>>");
 }
 
 TEST(Unit_AuxData, typeName) {
@@ -262,6 +272,101 @@ TEST(Unit_AuxData, vectorProtobufRoundTrip) {
   EXPECT_EQ(*Result.get<decltype(V)>(), V);
 }
 
+TEST(Unit_AuxData, bulkVectorMatchesElementwiseEncoding) {
+  // Vectors of fixed-size types are copied in bulk, and must produce the
+  // same bytes as containers which are serialized element by element.
+  std::vector<uint32_t> V;
+  for (uint32_t I = 0; I < 1000; ++I)
+    V.push_back(I * 0x01010101u);
+  AuxData FromVector = V;
+  AuxData FromList = std::list<uint32_t>(V.begin(), V.end());
+
+  auto VectorMessage = toProtobuf(FromVector);
+  auto ListMessage = toProtobuf(FromList);
+  EXPECT_EQ(VectorMessage.data(), ListMessage.data());
+
+  AuxData Result;
+  fromProtobuf(Ctx, Result, ListMessage);
+  EXPECT_EQ(*Result.get<std::vector<uint32_t>>(), V);
+}
+
+TEST(Unit_AuxData, bulkVectorProtobufRoundTrip) {
+  using T = std::tuple<std::vector<Addr>, std::vector<std::vector<uint16_t>>,
+                       std::vector<int8_t>>;
+  T V{{Addr(1), Addr(0xFFFFFFFFFFFFFFFF)}, {{1, 2}, {}, {0xFFFF}}, {}};
+  AuxData Original = V;
+
+  auto Message = toProtobuf(Original);
+  AuxData Result;
+  fromProtobuf(Ctx, Result, Message);
+
+  EXPECT_EQ(*Result.get<T>(), V);
+}
+
+TEST(Unit_AuxData, viewSequence) {
+  std::vector<Addr> V{Addr(1), Addr(0x1000), Addr(0xFFFFFFFFFFFFFFFF)};
+  AuxData Original = V;
+
+  AuxData Result;
+  fromProtobuf(Ctx, Result, toProtobuf(Original));
+
+  auto View = Result.view<std::vector<Addr>>();
+  ASSERT_TRUE(View.has_value());
+  ASSERT_EQ(View->size(), 3);
+  EXPECT_EQ((*View)[1], Addr(0x1000));
+  EXPECT_EQ(std::vector<Addr>(View->begin(), View->end()), V);
+  EXPECT_EQ(View->end() - View->begin(), 3);
+
+  // Views of other containers of the same kind are allowed.
+  EXPECT_TRUE(Result.view<std::list<Addr>>().has_value());
+  EXPECT_FALSE(Result.view<std::vector<uint64_t>>().has_value());
+
+  // Decoding the contents invalidates views.
+  EXPECT_EQ(*Result.get<std::vector<Addr>>(), V);
+  EXPECT_FALSE(Result.view<std::vector<Addr>>().has_value());
+  EXPECT_FALSE(Original.view<std::vector<Addr>>().has_value());
+}
+
+TEST(Unit_AuxData, viewMapping) {
+  using MapT = std::map<Addr, std::tuple<uint32_t, int8_t>>;
+  MapT M{{Addr(1), {10, -1}}, {Addr(5), {50, -5}}, {Addr(9), {90, -9}}};
+  AuxData Original = M;
+
+  AuxData Result;
+  fromProtobuf(Ctx, Result, toProtobuf(Original));
+
+  auto View = Result.view<MapT>();
+  ASSERT_TRUE(View.has_value());
+  ASSERT_EQ(View->size(), 3);
+  auto Found = std::lower_bound(
+      View->begin(), View->end(), Addr(5),
+      [](const auto& Entry, Addr A) { return Entry.first < A; });
+  ASSERT_NE(Found, View->end());
+  EXPECT_EQ((*Found).first, Addr(5));
+  EXPECT_EQ(std::get<0>((*Found).second), 50);
+  EXPECT_EQ(std::get<1>((*Found).second), -5);
+  EXPECT_EQ(MapT(View->begin(), View->end()), M);
+}
+
+TEST(Unit_AuxData, viewFromBytes) {
+  AuxData Original = std::vector<uint16_t>{1, 2, 3};
+  std::string Bytes = toProtobuf(Original).data();
+  auto AsBytes = [](const std::string& S) {
+    return gsl::as_bytes(gsl::span<const char>(S.data(), S.size()));
+  };
+
+  auto View = AuxDataView<std::vector<uint16_t>>::fromBytes(AsBytes(Bytes));
+  ASSERT_TRUE(View.has_value());
+  EXPECT_EQ((*View)[2], 3);
+
+  // Truncated input is rejected.
+  Bytes.pop_back();
+  EXPECT_FALSE(AuxDataView<std::vector<uint16_t>>::fromBytes(AsBytes(Bytes))
+                   .has_value());
+  using ViewT = AuxDataView<std::vector<uint16_t>>;
+  EXPECT_FALSE(ViewT::fromBytes(AsBytes("abc")).has_value());
+}
+
 TEST(Unit_AuxData, listProtobufRoundTrip) {
   std::list<int64_t> V({1, 2, 3});
   AuxData Original;
@@ -323,6 +428,231 @@ TEST(Unit_AuxData, mapProtobufRoundTrip) {
   EXPECT_EQ(*Result.get<decltype(M)>(), M);
 }
 
+TEST(Unit_AuxData, lookup) {
+  using MapT = std::map<int64_t, std::string>;
+  MapT M;
+  for (int64_t I = 0; I < 100; I += 2)
+    M[I] = std::to_string(I);
+
+  AuxData Original;
+  Original = M;
+
+  // Decoded contents.
+  EXPECT_EQ(Original.lookup<MapT>(42), "42");
+  EXPECT_EQ(Original.lookup<MapT>(43), std::nullopt);
+
+  // Serialized contents are searched without being decoded, and keep the
+  // usual type name and layout.
+  auto Message = toProtobuf(Original);
+  EXPECT_EQ(Message.type_name(), "mapping<int64_t,string>");
+  AuxData Result;
+  fromProtobuf(Ctx, Result, Message);
+  for (int64_t I = -1; I <= 100; ++I) {
+    auto V = Result.lookup<MapT>(I);
+    if (I >= 0 && I < 100 && I % 2 == 0)
+      EXPECT_EQ(V, std::to_string(I));
+    else
+      EXPECT_EQ(V, std::nullopt);
+  }
+  using OtherT = std::map<int64_t, int64_t>;
+  EXPECT_EQ(Result.lookup<OtherT>(42), std::nullopt);
+  EXPECT_EQ(*Result.get<MapT>(), M);
+
+  AuxData Empty;
+  Empty = MapT();
+  fromProtobuf(Ctx, Result, toProtobuf(Empty));
+  EXPECT_EQ(Result.lookup<MapT>(0), std::nullopt);
+}
+
+TEST(Unit_AuxData, lookupUnorderedMapping) {
+  using MapT = std::unordered_map<std::string, int64_t>;
+  MapT M({{"foo", 1}, {"bar", 2}, {"baz", 3}});
+  AuxData Original;
+  Original = M;
+
+  AuxData Result;
+  fromProtobuf(Ctx, Result, toProtobuf(Original));
+  EXPECT_EQ(Result.lookup<MapT>("foo"), 1);
+  EXPECT_EQ(Result.lookup<MapT>("bar"), 2);
+  EXPECT_EQ(Result.lookup<MapT>("baz"), 3);
+  EXPECT_EQ(Result.lookup<MapT>("qux"), std::nullopt);
+  // A std::map of the same types shares the serialized form.
+  using OrderedT = std::map<std::string, int64_t>;
+  EXPECT_EQ(Result.lookup<OrderedT>("baz"), 3);
+  EXPECT_EQ(*Result.get<MapT>(), M);
+}
+
+TEST(Unit_AuxData, lookupTruncated) {
+  using MapT = std::map<int64_t, int64_t>;
+  AuxData Original;
+  Original = MapT({{1, 10}, {2, 20}, {3, 30}});
+  auto Message = toProtobuf(Original);
+
+  // Drop part of the last entry.
+  auto Truncated = Message;
+  Truncated.mutable_data()->resize(Message.data().size() - 4);
+  AuxData Result;
+  fromProtobuf(Ctx, Result, Truncated);
+  EXPECT_EQ(Result.lookup<MapT>(1), std::nullopt);
+  EXPECT_EQ(Result.lookup<MapT>(3), std::nullopt);
+
+  // A count larger than the entries present.
+  auto Overcounted = Message;
+  (*Overcounted.mutable_data())[7] = '\x7f';
+  fromProtobuf(Ctx, Result, Overcounted);
+  EXPECT_EQ(Result.lookup<MapT>(2), std::nullopt);
+
+  // Too short to hold a count.
+  Truncated.mutable_data()->resize(3);
+  fromProtobuf(Ctx, Result, Truncated);
+  EXPECT_EQ(Result.lookup<MapT>(1), std::nullopt);
+}
+
+TEST(Unit_AuxData, column) {
+  using Functions = std::vector<std::tuple<std::string, Addr, uint64_t>>;
+  Functions F{{"a", Addr(1), 10}, {"b", Addr(5), 20}, {"c", Addr(9), 5}};
+  std::vector<Addr> Addrs{Addr(1), Addr(5), Addr(9)};
+  std::vector<uint64_t> Sizes{10, 20, 5};
+
+  AuxData Original;
+  Original = F;
+  EXPECT_EQ((Original.column<Functions, 1>()), Addrs);
+
+  // Serialized contents keep the usual type name and layout.
+  auto Message = toProtobuf(Original);
+  EXPECT_EQ(Message.type_name(), "sequence<tuple<string,Addr,uint64_t>>");
+  AuxData Result;
+  fromProtobuf(Ctx, Result, Message);
+  EXPECT_EQ((Result.column<Functions, 1>()), Addrs);
+  EXPECT_EQ((Result.column<Functions, 2>()), Sizes);
+  EXPECT_EQ((Result.column<Functions, 0>()),
+            std::vector<std::string>({"a", "b", "c"}));
+  using OtherT = std::vector<std::tuple<std::string, Addr, int64_t>>;
+  EXPECT_EQ((Result.column<OtherT, 1>()), std::nullopt);
+  // A list of the same rows shares the serialized form.
+  using FunctionList = std::list<std::tuple<std::string, Addr, uint64_t>>;
+  EXPECT_EQ((Result.column<FunctionList, 2>()), Sizes);
+  EXPECT_EQ(*Result.get<Functions>(), F);
+
+  AuxData Empty;
+  Empty = Functions();
+  fromProtobuf(Ctx, Result, toProtobuf(Empty));
+  EXPECT_EQ((Result.column<Functions, 0>()), std::vector<std::string>());
+}
+
+TEST(Unit_AuxData, typeHash) {
+  static_assert(typeNameHash("Addr") != typeNameHash("UUID"));
+  EXPECT_EQ(TypeId<std::vector<Addr>>::hash(),
+            typeNameHash("sequence<Addr>"));
+
+  std::map<Addr, uint64_t> M{{Addr(1), 2}};
+  AuxData Original;
+  Original = M;
+  EXPECT_EQ(Original.typeHash(), typeNameHash("mapping<Addr,uint64_t>"));
+  EXPECT_TRUE(Original.storesType<decltype(M)>());
+  using OtherT = std::map<Addr, int64_t>;
+  EXPECT_FALSE(Original.storesType<OtherT>());
+
+  AuxData Result;
+  fromProtobuf(Ctx, Result, toProtobuf(Original));
+  EXPECT_EQ(Result.typeHash(), typeNameHash("mapping<Addr,uint64_t>"));
+  EXPECT_EQ(Result.typeName(), "mapping<Addr,uint64_t>");
+  EXPECT_TRUE(Result.storesType<decltype(M)>());
+  EXPECT_FALSE(Result.storesType<OtherT>());
+  EXPECT_EQ(Result.get<OtherT>(), nullptr);
+  EXPECT_EQ(*Result.get<decltype(M)>(), M);
+}
+
+TEST(Unit_AuxData, typeRegistry) {
+  using Functions = std::vector<std::tuple<std::string, Addr>>;
+  AuxDataTypeRegistry Registry;
+  Registry.registerType<std::map<Addr, uint64_t>>();
+  Registry.registerType<Functions>();
+  EXPECT_EQ(Registry.size(), 2);
+
+  const auto* Entry = Registry.find("sequence<tuple<string,Addr>>");
+  ASSERT_NE(Entry, nullptr);
+  EXPECT_EQ(Entry->TypeName, "sequence<tuple<string,Addr>>");
+  EXPECT_EQ(*Entry->Type, typeid(Functions));
+  EXPECT_EQ(Registry.find("sequence<Addr>"), nullptr);
+
+  AuxData Original;
+  Original = Functions{{"main", Addr(1)}};
+  AuxData Result;
+  fromProtobuf(Ctx, Result, toProtobuf(Original));
+  Entry = Registry.findFor(Result);
+  ASSERT_NE(Entry, nullptr);
+  EXPECT_TRUE(Entry->Decode(Result));
+  EXPECT_EQ(*Result.get<Functions>(), Functions({{"main", Addr(1)}}));
+
+  // A later registration under the same name takes precedence.
+  using FunctionList = std::list<std::tuple<std::string, Addr>>;
+  Registry.registerType<FunctionList>();
+  EXPECT_EQ(*Registry.findFor(Result)->Type, typeid(FunctionList));
+}
+
+TEST(Unit_AuxData, setProtobufRoundTrip) {
+  std::set<Addr> S({Addr(3), Addr(1), Addr(2)});
+  AuxData Original;
+  Original = S;
+
+  auto Message = toProtobuf(Original);
+  AuxData Result;
+  fromProtobuf(Ctx, Result, Message);
+  EXPECT_EQ(*Result.get<decltype(S)>(), S);
+
+  // Sets of either kind share a serialized form.
+  AuxData Hashed;
+  fromProtobuf(Ctx, Hashed, Message);
+  auto* U = Hashed.get<std::unordered_set<Addr>>();
+  ASSERT_NE(U, nullptr);
+  EXPECT_EQ(U->size(), 3);
+  EXPECT_EQ(U->count(Addr(2)), 1);
+  EXPECT_GE(U->bucket_count() * U->max_load_factor(), 3);
+}
+
+TEST(Unit_AuxData, multimapProtobufRoundTrip) {
+  std::multimap<int64_t, std::string> M(
+      {{1, "a"}, {1, "b"}, {2, "c"}, {1, "d"}});
+  AuxData Original;
+  Original = M;
+
+  auto Message = toProtobuf(Original);
+  EXPECT_EQ(Message.type_name(), "multimapping<int64_t,string>");
+  AuxData Result;
+  fromProtobuf(Ctx, Result, Message);
+  EXPECT_EQ(*Result.get<decltype(M)>(), M);
+
+  // A multimap is not interchangeable with a map.
+  AuxData AsMap;
+  fromProtobuf(Ctx, AsMap, Message);
+  using MapT = std::map<int64_t, std::string>;
+  EXPECT_EQ(AsMap.get<MapT>(), nullptr);
+
+  AuxData Hashed;
+  fromProtobuf(Ctx, Hashed, Message);
+  using HashedT = std::unordered_multimap<int64_t, std::string>;
+  auto* U = Hashed.get<HashedT>();
+  ASSERT_NE(U, nullptr);
+  EXPECT_EQ(U->count(1), 3);
+  EXPECT_EQ(U->count(2), 1);
+}
+
+TEST(Unit_AuxData, optionalAndVariantProtobufRoundTrip) {
+  using Value = std::variant<Addr, std::string, int64_t>;
+  std::vector<std::optional<Value>> V(
+      {Value(Addr(1)), std::nullopt, Value(std::string("x")), Value(-2)});
+  AuxData Original;
+  Original = V;
+
+  auto Message = toProtobuf(Original);
+  EXPECT_EQ(Message.type_name(),
+            "sequence<option<variant<Addr,string,int64_t>>>");
+  AuxData Result;
+  fromProtobuf(Ctx, Result, Message);
+  EXPECT_EQ(*Result.get<decltype(V)>(), V);
+}
+
 TEST(Unit_AuxData, tupleProtobufRoundTrip) {
   std::tuple<char, int64_t> T('a', 1);
   AuxData Original;
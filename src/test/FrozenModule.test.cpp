@@ -0,0 +1,343 @@
+//===- FrozenModule.test.cpp ------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include <gtirb/Block.hpp>
+#include <gtirb/Context.hpp>
+#include <gtirb/DataObject.hpp>
+#include <gtirb/FrozenModule.hpp>
+#include <gtirb/Module.hpp>
+#include <gtirb/Section.hpp>
+#include <gtirb/Symbol.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <iterator>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace gtirb;
+
+static Context Ctx;
+
+TEST(Unit_FrozenModule, symbols) {
+  auto* M = Module::Create(Ctx);
+  auto* S1 = emplaceSymbol(*M, Ctx, Addr(1), "foo");
+  auto* S2 = emplaceSymbol(*M, Ctx, Addr(1), "bar");
+  auto* S3 = emplaceSymbol(*M, Ctx, Addr(2), "foo");
+  auto* S4 = emplaceSymbol(*M, Ctx, "foobar");
+
+  FrozenModule F = M->freeze();
+  EXPECT_EQ(std::distance(F.symbols().begin(), F.symbols().end()), 4);
+  EXPECT_EQ(&*F.symbols().begin(), S2);
+
+  {
+    auto R = F.findSymbols("foo");
+    ASSERT_EQ(std::distance(R.begin(), R.end()), 2);
+    EXPECT_EQ(&*R.begin(), S1);
+    EXPECT_EQ(&*std::next(R.begin()), S3);
+  }
+  EXPECT_TRUE(F.findSymbols("notfound").empty());
+
+  {
+    auto R = F.findSymbolsByPrefix("foo");
+    ASSERT_EQ(std::distance(R.begin(), R.end()), 3);
+    EXPECT_EQ(&*std::next(R.begin(), 2), S4);
+  }
+
+  {
+    auto R = F.findSymbols(Addr(1));
+    ASSERT_EQ(std::distance(R.begin(), R.end()), 2);
+    EXPECT_EQ(&*R.begin(), S1);
+    EXPECT_EQ(&*std::next(R.begin()), S2);
+  }
+
+  {
+    auto R = F.findSymbols(Addr(0), Addr(5));
+    EXPECT_EQ(std::distance(R.begin(), R.end()), 3);
+  }
+
+  // Later changes to the module are not reflected in the snapshot.
+  renameSymbol(*M, *S1, "renamed");
+  emplaceSymbol(*M, Ctx, Addr(3), "new");
+  EXPECT_EQ(std::distance(F.findSymbols("foo").begin(),
+                          F.findSymbols("foo").end()),
+            2);
+  EXPECT_TRUE(F.findSymbols(Addr(3)).empty());
+}
+
+TEST(Unit_FrozenModule, data) {
+  auto* M = Module::Create(Ctx);
+  auto* D1 = DataObject::Create(Ctx, Addr(1), 20);
+  auto* D2 = DataObject::Create(Ctx, Addr(5), 10);
+  M->addData({D2, D1});
+
+  FrozenModule F = M->freeze();
+  EXPECT_EQ(&*F.data().begin(), D1);
+  EXPECT_TRUE(F.findData(Addr(0)).empty());
+  EXPECT_EQ(std::distance(F.findData(Addr(1)).begin(),
+                          F.findData(Addr(1)).end()),
+            1);
+  EXPECT_EQ(std::distance(F.findData(Addr(14)).begin(),
+                          F.findData(Addr(14)).end()),
+            2);
+  EXPECT_EQ(&*F.findData(Addr(20)).begin(), D1);
+  EXPECT_TRUE(F.findData(Addr(21)).empty());
+}
+
+TEST(Unit_FrozenModule, sections) {
+  auto* M = Module::Create(Ctx);
+  auto* S1 = Section::Create(Ctx, "a", Addr(10), 10);
+  auto* S2 = Section::Create(Ctx, "b", Addr(20), 10);
+  M->addSection({S2, S1});
+
+  FrozenModule F = M->freeze();
+  EXPECT_EQ(&*F.sections().begin(), S1);
+  EXPECT_EQ(F.findSection(Addr(20)), S2);
+  EXPECT_EQ(F.findSection(Addr(15)), nullptr);
+}
+
+TEST(Unit_FrozenModule, symbolicExpressions) {
+  auto* M = Module::Create(Ctx);
+  auto* S1 = Symbol::Create(Ctx, Addr(1), "foo");
+  auto* S2 = Symbol::Create(Ctx, Addr(5), "bar");
+  M->addSymbolicExpression(Addr(5), SymAddrConst{0, S2});
+  M->addSymbolicExpression(Addr(1), SymAddrConst{0, S1});
+
+  FrozenModule F = M->freeze();
+  ASSERT_EQ(F.symbolicExpressions().size(), 2);
+  EXPECT_EQ(F.symbolicExpressionAddrs()[0], Addr(1));
+
+  auto R = F.findSymbolicExpression(Addr(1), Addr(5));
+  ASSERT_EQ(R.size(), 1);
+  EXPECT_EQ(std::get<SymAddrConst>(R[0]).Sym, S1);
+  EXPECT_EQ(F.findSymbolicExpression(Addr(0), Addr(1)).size(), 0);
+
+  ASSERT_NE(F.findSymbolicExpression(Addr(5)), nullptr);
+  EXPECT_EQ(std::get<SymAddrConst>(*F.findSymbolicExpression(Addr(5))).Sym,
+            S2);
+  EXPECT_EQ(F.findSymbolicExpression(Addr(3)), nullptr);
+}
+
+TEST(Unit_FrozenModule, cfg) {
+  auto* M = Module::Create(Ctx);
+  auto& Cfg = M->getCFG();
+  auto* B1 = emplaceBlock(Cfg, Ctx, Addr(1), 2);
+  auto* B2 = emplaceBlock(Cfg, Ctx, Addr(3), 2);
+  auto* B3 = emplaceBlock(Cfg, Ctx, Addr(5), 2);
+  auto E1 = addEdge(B1, B2, Cfg);
+  auto E2 = addEdge(B1, B3, Cfg);
+  addEdge(B2, B3, Cfg);
+  Cfg[E1] = true;
+  Cfg[E2] = false;
+
+  FrozenModule F = M->freeze();
+  EXPECT_EQ(std::distance(F.blocks().begin(), F.blocks().end()), 3);
+
+  {
+    auto R = F.successors(*B1);
+    ASSERT_EQ(std::distance(R.begin(), R.end()), 2);
+    EXPECT_EQ(&*R.begin(), B2);
+    EXPECT_EQ(&*std::next(R.begin()), B3);
+    auto L = F.successorLabels(*B1);
+    ASSERT_EQ(L.size(), 2);
+    EXPECT_EQ(std::get<bool>(L[0]), true);
+    EXPECT_EQ(std::get<bool>(L[1]), false);
+  }
+
+  EXPECT_TRUE(F.successors(*B3).empty());
+  EXPECT_TRUE(F.predecessors(*B1).empty());
+
+  {
+    auto R = F.predecessors(*B3);
+    ASSERT_EQ(std::distance(R.begin(), R.end()), 2);
+    EXPECT_EQ(F.predecessorLabels(*B3).size(), 2);
+  }
+}
+
+TEST(Unit_FrozenModule, blockColumns) {
+  auto* M = Module::Create(Ctx);
+  auto& Cfg = M->getCFG();
+  // Created out of address order.
+  auto* B1 = emplaceBlock(Cfg, Ctx, Addr(30), 4, Block::Exit::Return);
+  auto* B2 = emplaceBlock(Cfg, Ctx, Addr(10), 2, Block::Exit::Call, 1);
+  auto* B3 = emplaceBlock(Cfg, Ctx, Addr(20), 8, Block::Exit::Call);
+  auto* B4 = emplaceBlock(Cfg, Ctx, Addr(10), 6);
+
+  FrozenModule F = M->freeze();
+  const BlockColumns& Columns = F.blockColumns();
+  ASSERT_EQ(Columns.size(), 4);
+  EXPECT_EQ(Columns.addresses()[0], Addr(10));
+  EXPECT_EQ(Columns.addresses()[1], Addr(10));
+  EXPECT_EQ(Columns.addresses()[2], Addr(20));
+  EXPECT_EQ(Columns.addresses()[3], Addr(30));
+  EXPECT_EQ(&Columns.block(0), B2);
+  EXPECT_EQ(&Columns.block(1), B4);
+  EXPECT_EQ(Columns.sizes()[1], 6);
+  EXPECT_EQ(Columns.exitKinds()[3], Block::Exit::Return);
+  EXPECT_EQ(Columns.decodeModes()[0], 1);
+
+  EXPECT_EQ(Columns.indexOf(*B1), 3);
+  EXPECT_EQ(Columns.indexOf(*B3), 2);
+  auto* Other = Module::Create(Ctx);
+  auto* Foreign = emplaceBlock(Other->getCFG(), Ctx, Addr(10), 2);
+  EXPECT_EQ(Columns.indexOf(*Foreign), std::nullopt);
+
+  using Range = std::pair<BlockColumns::Index, BlockColumns::Index>;
+  EXPECT_EQ(Columns.findBlocks(Addr(10), Addr(30)), Range(0, 3));
+  EXPECT_EQ(Columns.findBlocks(Addr(11), Addr(20)), Range(2, 2));
+  EXPECT_EQ(Columns.findBlocks(Addr(0), Addr(100), Block::Exit::Call),
+            std::vector<BlockColumns::Index>({0, 2}));
+  EXPECT_TRUE(
+      Columns.findBlocks(Addr(11), Addr(20), Block::Exit::Call).empty());
+
+  EXPECT_TRUE(BlockColumns().empty());
+  EXPECT_EQ(BlockColumns(Cfg).size(), 4);
+}
+
+TEST(Unit_FrozenModule, findContents) {
+  auto* M = Module::Create(Ctx);
+  auto* Text = Section::Create(Ctx, ".text", Addr(0x100), 0x20);
+  auto* DataSec = Section::Create(Ctx, ".data", Addr(0x200), 0x10);
+  M->addSection({Text, DataSec});
+  auto* B1 = emplaceBlock(M->getCFG(), Ctx, Addr(0x100), 0x10);
+  auto* B2 = emplaceBlock(M->getCFG(), Ctx, Addr(0x110), 0x8);
+  auto* D = DataObject::Create(Ctx, Addr(0x200), 8);
+  M->addData(D);
+  auto* Sym = emplaceSymbol(*M, Ctx, B2, "b2");
+  M->addSymbolicExpression(Addr(0x104), SymAddrConst{0, Sym});
+  auto& IBM = M->getImageByteMap();
+  IBM.setAddrMinMax({Addr(0x100), Addr(0x300)});
+  std::vector<std::byte> Bytes(0x20);
+  for (size_t I = 0; I < Bytes.size(); ++I)
+    Bytes[I] = std::byte(I);
+  IBM.setData(Addr(0x100), gsl::span<const std::byte>(Bytes));
+
+  FrozenModule F = M->freeze();
+  // Changing the module's bytes afterwards does not change the snapshot.
+  IBM.setData(Addr(0x100), gsl::span<const std::byte>(Bytes).subspan(0, 1));
+
+  auto AtStart = F.findContents(Addr(0x104));
+  EXPECT_EQ(AtStart.Sec, Text);
+  EXPECT_EQ(AtStart.Blk, B1);
+  EXPECT_TRUE(AtStart.Data.empty());
+  EXPECT_TRUE(AtStart.Symbols.empty());
+  ASSERT_NE(AtStart.SymbolicExpr, nullptr);
+  EXPECT_EQ(std::get<SymAddrConst>(*AtStart.SymbolicExpr).Sym, Sym);
+  ASSERT_EQ(AtStart.Bytes.size(), 0x1c);
+  EXPECT_EQ(AtStart.Bytes[0], std::byte(4));
+
+  auto AtB2 = F.findContents(Addr(0x110));
+  EXPECT_EQ(AtB2.Blk, B2);
+  ASSERT_EQ(std::distance(AtB2.Symbols.begin(), AtB2.Symbols.end()), 1);
+  EXPECT_EQ(&*AtB2.Symbols.begin(), Sym);
+  EXPECT_EQ(AtB2.SymbolicExpr, nullptr);
+
+  auto Unmapped = F.findContents(Addr(0x120));
+  EXPECT_EQ(Unmapped.Sec, nullptr);
+  EXPECT_EQ(Unmapped.Blk, nullptr);
+  EXPECT_TRUE(Unmapped.Bytes.empty());
+
+  auto InData = F.findContents(Addr(0x204));
+  EXPECT_EQ(InData.Sec, DataSec);
+  ASSERT_EQ(std::distance(InData.Data.begin(), InData.Data.end()), 1);
+  EXPECT_EQ(&*InData.Data.begin(), D);
+
+  // A batched query gives the same results as separate ones.
+  std::vector<Addr> Addrs{Addr(0x0),   Addr(0x104), Addr(0x110),
+                          Addr(0x117), Addr(0x120), Addr(0x204)};
+  auto Batch = F.findContents(Addrs);
+  ASSERT_EQ(Batch.size(), Addrs.size());
+  for (size_t I = 0; I < Addrs.size(); ++I) {
+    auto One = F.findContents(Addrs[I]);
+    EXPECT_EQ(Batch[I].Sec, One.Sec);
+    EXPECT_EQ(Batch[I].Blk, One.Blk);
+    EXPECT_TRUE(Batch[I].Data.begin() == One.Data.begin());
+    EXPECT_TRUE(Batch[I].Data.end() == One.Data.end());
+    EXPECT_TRUE(Batch[I].Symbols.begin() == One.Symbols.begin());
+    EXPECT_TRUE(Batch[I].Symbols.end() == One.Symbols.end());
+    EXPECT_EQ(Batch[I].SymbolicExpr, One.SymbolicExpr);
+    EXPECT_EQ(Batch[I].Bytes.data(), One.Bytes.data());
+    EXPECT_EQ(Batch[I].Bytes.size(), One.Bytes.size());
+  }
+
+  auto Range = F.findContents(Addr(0x104), Addr(0x118));
+  EXPECT_TRUE(Range.Sections.empty());
+  EXPECT_EQ(Range.Blocks.second - Range.Blocks.first, 1);
+  EXPECT_EQ(std::distance(Range.Symbols.begin(), Range.Symbols.end()), 1);
+  EXPECT_EQ(Range.SymbolicExprs.size(), 1);
+  ASSERT_EQ(Range.Bytes.size(), 0x14);
+  EXPECT_EQ(Range.Bytes[0], std::byte(4));
+  EXPECT_TRUE(F.findContents(Addr(0x110), Addr(0x130)).Bytes.empty());
+}
+
+TEST(Unit_FrozenModule, findContentsNested) {
+  auto* M = Module::Create(Ctx);
+  auto* All = Section::Create(Ctx, ".all", Addr(0x100), 0x200);
+  auto* Inner = Section::Create(Ctx, ".inner", Addr(0x180), 0x10);
+  M->addSection({All, Inner});
+  auto& Cfg = M->getCFG();
+  auto* Outer = emplaceBlock(Cfg, Ctx, Addr(0x100), 0x100);
+  auto* Inner1 = emplaceBlock(Cfg, Ctx, Addr(0x110), 0x10);
+  emplaceBlock(Cfg, Ctx, Addr(0x130), 0);
+  auto* Inner2 = emplaceBlock(Cfg, Ctx, Addr(0x140), 0x10);
+  auto* Tail = emplaceBlock(Cfg, Ctx, Addr(0x1f0), 0x20);
+  FrozenModule F = M->freeze();
+
+  // The innermost block or section is found, whatever it is nested in.
+  std::vector<std::tuple<Addr, const Section*, const Block*>> Expected{
+      {Addr(0xff), nullptr, nullptr}, {Addr(0x100), All, Outer},
+      {Addr(0x115), All, Inner1},     {Addr(0x120), All, Outer},
+      {Addr(0x130), All, Outer},      {Addr(0x145), All, Inner2},
+      {Addr(0x150), All, Outer},      {Addr(0x185), Inner, Outer},
+      {Addr(0x190), All, Outer},      {Addr(0x1f8), All, Tail},
+      {Addr(0x205), All, Tail},       {Addr(0x210), All, nullptr},
+      {Addr(0x300), nullptr, nullptr}};
+  std::vector<Addr> Addrs;
+  for (const auto& [X, Sec, Blk] : Expected) {
+    auto Found = F.findContents(X);
+    EXPECT_EQ(Found.Sec, Sec) << "at " << uint64_t(X);
+    EXPECT_EQ(Found.Blk, Blk) << "at " << uint64_t(X);
+    Addrs.push_back(X);
+  }
+  auto Batch = F.findContents(Addrs);
+  for (size_t I = 0; I < Addrs.size(); ++I) {
+    EXPECT_EQ(Batch[I].Sec, std::get<1>(Expected[I]));
+    EXPECT_EQ(Batch[I].Blk, std::get<2>(Expected[I]));
+  }
+}
+
+TEST(Unit_FrozenModule, concurrentReads) {
+  auto* M = Module::Create(Ctx);
+  std::vector<Symbol*> Syms;
+  for (uint64_t I = 0; I < 1000; ++I)
+    Syms.push_back(Symbol::Create(Ctx, Addr(I), "sym" + std::to_string(I)));
+  M->addSymbol(Syms.begin(), Syms.end());
+  const FrozenModule F = M->freeze();
+
+  std::atomic<int> Failures{0};
+  std::vector<std::thread> Threads;
+  for (int T = 0; T < 4; ++T) {
+    Threads.emplace_back([&F, &Syms, &Failures]() {
+      for (uint64_t I = 0; I < Syms.size(); ++I) {
+        auto R = F.findSymbols("sym" + std::to_string(I));
+        if (R.empty() || &*R.begin() != Syms[I] ||
+            &*F.findSymbols(Addr(I)).begin() != Syms[I])
+          ++Failures;
+      }
+    });
+  }
+  for (auto& T : Threads)
+    T.join();
+  EXPECT_EQ(Failures, 0);
+}
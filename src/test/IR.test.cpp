@@ -13,15 +13,19 @@
 //
 //===----------------------------------------------------------------------===//
 #include <gtirb/AuxData.hpp>
+#include <gtirb/AuxDataTypeRegistry.hpp>
 #include <gtirb/Context.hpp>
 #include <gtirb/DataObject.hpp>
 #include <gtirb/IR.hpp>
 #include <gtirb/ImageByteMap.hpp>
 #include <gtirb/Module.hpp>
 #include <gtirb/Section.hpp>
+#include <gtirb/Stats.hpp>
 #include <gtirb/Symbol.hpp>
 #include <gtirb/SymbolicExpression.hpp>
 #include <proto/IR.pb.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <gtest/gtest.h>
 
 using namespace gtirb;
@@ -142,6 +146,28 @@ TEST(Unit_IR, protobufRoundTrip) {
   EXPECT_NE(Result->getAuxData("test"), nullptr);
 }
 
+TEST(Unit_IR, saveAndLoadAuxData) {
+  std::ostringstream Out;
+  std::vector<uint64_t> Table{1, 2, 3};
+
+  {
+    Context InnerCtx;
+    IR* Original = IR::Create(InnerCtx);
+    Original->addAuxData("table", Table);
+    Original->addAuxData("name", std::string("value"));
+    Original->save(Out);
+  }
+  std::istringstream In(Out.str());
+  IR* Result = IR::load(Ctx, In);
+
+  EXPECT_EQ(Result->getAuxDataSize(), 2);
+  auto View = Result->getAuxData("table")->view<std::vector<uint64_t>>();
+  ASSERT_TRUE(View.has_value());
+  EXPECT_EQ(std::vector<uint64_t>(View->begin(), View->end()), Table);
+  EXPECT_EQ(*Result->getAuxData("table")->get<std::vector<uint64_t>>(), Table);
+  EXPECT_EQ(*Result->getAuxData("name")->get<std::string>(), "value");
+}
+
 TEST(Unit_IR, jsonRoundTrip) {
   UUID MainID;
   std::ostringstream Out;
@@ -180,3 +206,426 @@ TEST(Unit_IR, move) {
   EXPECT_EQ(Moved.getAuxDataSize(), 1);
   EXPECT_NE(Moved.getAuxData("test"), nullptr);
 }
+
+TEST(Unit_IR, saveAndLoadManyAuxData) {
+  std::ostringstream Out;
+  std::vector<std::vector<int64_t>> Tables;
+  for (int64_t I = 0; I < 16; ++I)
+    Tables.push_back(std::vector<int64_t>(1000, I));
+
+  {
+    Context InnerCtx;
+    IR* Original = IR::Create(InnerCtx);
+    for (size_t I = 0; I < Tables.size(); ++I)
+      Original->addAuxData("table" + std::to_string(I), Tables[I]);
+    Original->save(Out);
+  }
+  std::istringstream In(Out.str());
+  IR* Result = IR::load(Ctx, In);
+
+  ASSERT_EQ(Result->getAuxDataSize(), Tables.size());
+  for (size_t I = 0; I < Tables.size(); ++I)
+    EXPECT_EQ(*Result->getAuxData("table" + std::to_string(I))
+                   ->get<std::vector<int64_t>>(),
+              Tables[I]);
+}
+
+TEST(Unit_IR, decodeAuxData) {
+  std::ostringstream Out;
+  std::vector<int64_t> Table{1, 2, 3};
+  std::map<std::string, int64_t> Map{{"a", 1}};
+
+  {
+    Context InnerCtx;
+    IR* Original = IR::Create(InnerCtx);
+    Original->addAuxData("table", Table);
+    Original->addAuxData("map", Map);
+    Original->save(Out);
+  }
+
+  {
+    std::istringstream In(Out.str());
+    IR* Result = IR::load(Ctx, In);
+    EXPECT_TRUE((Result->decodeAuxData<std::vector<int64_t>,
+                                       std::map<std::string, int64_t>>(
+        "table", "map")));
+    EXPECT_EQ(*Result->getAuxData("table")->get<std::vector<int64_t>>(),
+              Table);
+    using MapT = std::map<std::string, int64_t>;
+    EXPECT_EQ(*Result->getAuxData("map")->get<MapT>(), Map);
+    // Already decoded tables are left as they are.
+    EXPECT_TRUE(Result->decodeAuxData<std::vector<int64_t>>("table"));
+  }
+
+  {
+    Context OtherCtx;
+    std::istringstream In(Out.str());
+    IR* Result = IR::load(OtherCtx, In);
+    EXPECT_FALSE((Result->decodeAuxData<std::vector<int64_t>,
+                                        std::vector<int64_t>>("table",
+                                                              "missing")));
+    EXPECT_FALSE(Result->decodeAuxData<std::vector<std::string>>("map"));
+    EXPECT_EQ(*Result->getAuxData("table")->get<std::vector<int64_t>>(),
+              Table);
+  }
+}
+
+TEST(Unit_IR, decodeAuxDataWithRegistry) {
+  std::ostringstream Out;
+  std::vector<int64_t> Table{1, 2, 3};
+  std::map<std::string, int64_t> Map{{"a", 1}};
+
+  {
+    Context InnerCtx;
+    IR* Original = IR::Create(InnerCtx);
+    Original->addAuxData("table", Table);
+    Original->addAuxData("map", Map);
+    Original->save(Out);
+  }
+
+  Context InnerCtx;
+  std::istringstream In(Out.str());
+  IR* Result = IR::load(InnerCtx, In);
+  AuxDataTypeRegistry Registry;
+  Registry.registerType<std::vector<int64_t>>();
+  EXPECT_FALSE(Result->decodeAuxData(Registry));
+  EXPECT_TRUE(Result->getAuxData("table")->view<std::vector<int64_t>>() ==
+              std::nullopt);
+
+  Registry.registerType<std::map<std::string, int64_t>>();
+  EXPECT_TRUE(Result->decodeAuxData(Registry));
+  EXPECT_EQ(*Result->getAuxData("table")->get<std::vector<int64_t>>(), Table);
+  using MapT = std::map<std::string, int64_t>;
+  EXPECT_EQ(*Result->getAuxData("map")->get<MapT>(), Map);
+}
+
+namespace {
+struct RecordingSink : StatsSink {
+  std::map<std::string, PhaseStats> Totals;
+  std::map<std::string, int> Records;
+  void record(const PhaseStats& S) override {
+    ++Records[std::string(S.Phase)];
+    auto& T = Totals[std::string(S.Phase)];
+    T.Time += S.Time;
+    T.Bytes += S.Bytes;
+    T.Nodes += S.Nodes;
+  }
+};
+} // namespace
+
+TEST(Unit_IR, statsSink) {
+  RecordingSink SaveStats;
+  std::ostringstream Out;
+  {
+    Context InnerCtx;
+    IR* Original = IR::Create(InnerCtx);
+    for (int I = 0; I < 2; ++I) {
+      Module* M = Module::Create(InnerCtx);
+      auto* B = emplaceBlock(M->getCFG(), InnerCtx, Addr(0x1000), 8);
+      M->addSymbol(Symbol::Create(InnerCtx, B, "main"));
+      M->getImageByteMap().setData(Addr(0x1000), 8, std::byte(0x90));
+      Original->addModule(M);
+    }
+    Original->addAuxData("table", std::vector<int64_t>{1, 2, 3});
+    Original->save(Out);
+    EXPECT_TRUE(SaveStats.Totals.empty());
+
+    InnerCtx.setStatsSink(&SaveStats);
+    std::ostringstream Ignored;
+    Original->save(Ignored);
+    InnerCtx.setStatsSink(nullptr);
+  }
+  const auto& Saved = SaveStats.Totals;
+  EXPECT_EQ(Saved.at("IR::save/serialize").Bytes, Out.str().size());
+  EXPECT_EQ(Saved.at("IR::toProtobuf/modules").Nodes, 2);
+  EXPECT_EQ(Saved.at("IR::toProtobuf/auxData").Nodes, 1);
+  EXPECT_EQ(Saved.at("IR::toProtobuf/auxData").Bytes, 3 * 8 + 8);
+  EXPECT_EQ(Saved.at("Module::toProtobuf/byteMap").Bytes, 16);
+  EXPECT_EQ(Saved.at("Module::toProtobuf/cfg").Nodes, 2);
+  EXPECT_EQ(Saved.at("Module::toProtobuf/symbols").Nodes, 2);
+  EXPECT_EQ(Saved.count("Context/registerNode"), 0);
+
+  RecordingSink LoadStats;
+  Context InnerCtx;
+  InnerCtx.setStatsSink(&LoadStats);
+  std::istringstream In(Out.str());
+  IR::load(InnerCtx, In);
+  const auto& Loaded = LoadStats.Totals;
+  EXPECT_EQ(Loaded.at("IR::load/parse").Bytes, Out.str().size());
+  EXPECT_EQ(Loaded.at("IR::fromProtobuf/modules").Nodes, 2);
+  EXPECT_EQ(Loaded.at("IR::fromProtobuf/auxData").Nodes, 1);
+  EXPECT_EQ(Loaded.at("Module::fromProtobuf/byteMap").Bytes, 16);
+  EXPECT_EQ(Loaded.at("Module::fromProtobuf/cfg").Nodes, 2);
+  EXPECT_EQ(Loaded.at("CFG::fromProtobuf/blocks").Nodes, 2);
+  EXPECT_EQ(Loaded.at("CFG::fromProtobuf/edges").Nodes, 0);
+  EXPECT_EQ(Loaded.at("Module::fromProtobuf/symbols").Nodes, 2);
+  EXPECT_EQ(Loaded.at("Module::fromProtobuf/symbolIndex").Nodes, 2);
+  EXPECT_EQ(Loaded.at("Module::fromProtobuf/symbolicOperands").Nodes, 0);
+  EXPECT_GE(Loaded.at("IR::fromProtobuf/modules").Time,
+            Loaded.at("Module::fromProtobuf/cfg").Time);
+  // The IR, and each module with its image byte map, block and symbol.
+  EXPECT_EQ(LoadStats.Records.at("Context/registerNode"), 1);
+  EXPECT_GE(Loaded.at("Context/registerNode").Nodes, 9);
+}
+
+TEST(Unit_IR, mergeAcrossContexts) {
+  Context Main;
+  IR* Result = IR::Create(Main);
+  Module* First = Module::Create(Main);
+  Result->addModule(First);
+  Result->addAuxData("shared", std::vector<int64_t>{1});
+  // Interned in both Contexts.
+  First->addSymbol(Symbol::Create(Main, Addr(0x10), "main"));
+
+  UUID PartId, ModuleId, BlockId;
+  Symbol* Sym = nullptr;
+  const std::byte* Bytes = nullptr;
+  {
+    Context Worker;
+    IR* Part = IR::Create(Worker);
+    Module* M = Module::Create(Worker);
+    auto* B = emplaceBlock(M->getCFG(), Worker, Addr(0x1000), 4);
+    Sym = Symbol::Create(Worker, B, "main");
+    M->addSymbol(Sym);
+    M->getImageByteMap().setAddrMinMax({Addr(0x1000), Addr(0x2000)});
+    M->getImageByteMap().setData(Addr(0x1000), 4, std::byte(0x90));
+    Bytes = &*M->getImageByteMap().data(Addr(0x1000), 4).begin();
+    Part->addModule(M);
+    Part->addAuxData("shared", std::vector<int64_t>{2});
+    Part->addAuxData("extra", std::vector<int64_t>{3});
+    PartId = Part->getUUID();
+    ModuleId = M->getUUID();
+    BlockId = B->getUUID();
+
+    ASSERT_TRUE(Main.absorb(Worker));
+    EXPECT_EQ(Node::getByUUID(Worker, ModuleId), nullptr);
+    Result->merge(*Part);
+    EXPECT_TRUE(Part->modules().empty());
+    EXPECT_NE(Part->getAuxData("shared"), nullptr);
+    EXPECT_EQ(Part->getAuxData("extra"), nullptr);
+  }
+
+  // The Worker Context is gone, but its nodes live on in Main.
+  ASSERT_EQ(Result->modules().size(), 2);
+  Module& Merged = Result->modules()[1];
+  EXPECT_EQ(Merged.getUUID(), ModuleId);
+  EXPECT_EQ(Node::getByUUID(Main, ModuleId), &Merged);
+  EXPECT_NE(Node::getByUUID(Main, PartId), nullptr);
+  EXPECT_NE(Node::getByUUID(Main, BlockId), nullptr);
+  EXPECT_EQ(Sym->getName(), "main");
+  EXPECT_EQ(&*Merged.findSymbols("main").begin(), Sym);
+  EXPECT_EQ(std::distance(First->findSymbols("main").begin(),
+                          First->findSymbols("main").end()),
+            1);
+  EXPECT_EQ(&*Merged.getImageByteMap().data(Addr(0x1000), 4).begin(), Bytes);
+  EXPECT_EQ(*Result->getAuxData("shared")->get<std::vector<int64_t>>(),
+            std::vector<int64_t>{1});
+  EXPECT_EQ(*Result->getAuxData("extra")->get<std::vector<int64_t>>(),
+            std::vector<int64_t>{3});
+
+  // Nodes created in Main afterwards, and the merged IR, still round-trip.
+  Merged.addSymbol(Symbol::Create(Main, Addr(0x1002), "main"));
+  std::stringstream Out;
+  Result->save(Out);
+  Context Loaded;
+  IR* Copy = IR::load(Loaded, Out);
+  ASSERT_EQ(Copy->modules().size(), 2);
+  EXPECT_EQ(Copy->modules()[1].getUUID(), ModuleId);
+}
+
+TEST(Unit_IR, absorbRejectsSharedUUIDs) {
+  std::stringstream Out;
+  {
+    Context InnerCtx;
+    IR::Create(InnerCtx)->save(Out);
+  }
+  Context C1, C2;
+  std::stringstream In(Out.str());
+  IR* I1 = IR::load(C1, In);
+  In.str(Out.str());
+  In.clear();
+  IR::load(C2, In);
+  EXPECT_FALSE(C1.absorb(C2));
+  EXPECT_EQ(Node::getByUUID(C1, I1->getUUID()), I1);
+  EXPECT_NE(Node::getByUUID(C2, I1->getUUID()), nullptr);
+  EXPECT_TRUE(C1.absorb(C1));
+}
+
+TEST(Unit_IR, findGlobalSymbols) {
+  auto* Ir = IR::Create(Ctx);
+  auto* M1 = Module::Create(Ctx);
+  auto* M2 = Module::Create(Ctx);
+  auto* Def =
+      emplaceSymbol(*M1, Ctx, Addr(1), "f", Symbol::StorageKind::Normal);
+  auto* Ref = emplaceSymbol(*M2, Ctx, Addr(0), "f");
+  emplaceSymbol(*M2, Ctx, Addr(2), "f", Symbol::StorageKind::Local);
+  emplaceSymbol(*M2, Ctx, Addr(3), "g", Symbol::StorageKind::Undefined);
+  Ir->addModule({M1, M2});
+
+  auto Found = Ir->findGlobalSymbols("f");
+  ASSERT_EQ(boost::size(Found), 2);
+  EXPECT_EQ(&*Found.begin(), Def);
+  EXPECT_EQ(&*std::next(Found.begin()), Ref);
+  EXPECT_TRUE(Ir->findGlobalSymbols("g").empty());
+  EXPECT_TRUE(Ir->findGlobalSymbols("missing").empty());
+
+  // Modules added after the index was built are indexed as they are added.
+  auto* M3 = Module::Create(Ctx);
+  auto* Later =
+      emplaceSymbol(*M3, Ctx, Addr(4), "f", Symbol::StorageKind::Static);
+  Ir->addModule(M3);
+  const IR& ConstIr = *Ir;
+  EXPECT_EQ(boost::size(ConstIr.findGlobalSymbols("f")), 3);
+
+  // Changes to modules already in the IR are indexed when they are
+  // delivered to the modules' observers.
+  auto* H =
+      emplaceSymbol(*M1, Ctx, Addr(5), "h", Symbol::StorageKind::Normal);
+  EXPECT_TRUE(Ir->findGlobalSymbols("h").empty());
+  M1->notifyObservers();
+  ASSERT_EQ(boost::size(Ir->findGlobalSymbols("h")), 1);
+  EXPECT_EQ(&*Ir->findGlobalSymbols("h").begin(), H);
+
+  // Rebuilding the index first does not index them twice.
+  auto* I = emplaceSymbol(*M1, Ctx, Addr(6), "i", Symbol::StorageKind::Normal);
+  Ir->indexSymbols();
+  M1->notifyObservers();
+  ASSERT_EQ(boost::size(Ir->findGlobalSymbols("i")), 1);
+  EXPECT_EQ(&*Ir->findGlobalSymbols("i").begin(), I);
+
+  // Merging indexes the merged modules.
+  auto* Other = IR::Create(Ctx);
+  auto* M4 = Module::Create(Ctx);
+  emplaceSymbol(*M4, Ctx, Addr(6), "f", Symbol::StorageKind::Extern);
+  Other->addModule(M4);
+  Ir->merge(*Other);
+  auto Merged = Ir->findGlobalSymbols("f");
+  ASSERT_EQ(boost::size(Merged), 4);
+  EXPECT_EQ(&*std::next(Merged.begin(), 2), Later);
+  EXPECT_TRUE(Other->findGlobalSymbols("f").empty());
+}
+
+TEST(Unit_IR, findGlobalSymbolsFollowsChanges) {
+  auto* Ir = IR::Create(Ctx);
+  auto* M1 = Module::Create(Ctx);
+  auto* M2 = Module::Create(Ctx);
+  auto* F = emplaceSymbol(*M1, Ctx, Addr(1), "f");
+  auto* G = emplaceSymbol(*M2, Ctx, Addr(2), "g");
+  Ir->addModule({M1, M2});
+  Ir->indexSymbols();
+
+  // Renaming moves a symbol to its new name, in module order.
+  renameSymbol(*M2, *G, "f");
+  M2->notifyObservers();
+  EXPECT_TRUE(Ir->findGlobalSymbols("g").empty());
+  auto Found = Ir->findGlobalSymbols("f");
+  ASSERT_EQ(boost::size(Found), 2);
+  EXPECT_EQ(&*Found.begin(), F);
+  EXPECT_EQ(&*std::next(Found.begin()), G);
+
+  // Rolled back changes are undone in the index.
+  M1->beginTransaction();
+  renameSymbol(*M1, *F, "h");
+  emplaceSymbol(*M1, Ctx, Addr(3), "added");
+  M1->notifyObservers();
+  EXPECT_EQ(&*Ir->findGlobalSymbols("h").begin(), F);
+  EXPECT_EQ(boost::size(Ir->findGlobalSymbols("added")), 1);
+  M1->rollbackTransaction();
+  M1->notifyObservers();
+  EXPECT_TRUE(Ir->findGlobalSymbols("h").empty());
+  EXPECT_TRUE(Ir->findGlobalSymbols("added").empty());
+  EXPECT_EQ(&*Ir->findGlobalSymbols("f").begin(), F);
+
+  // A symbol shared with a clone is replaced by its copy.
+  Module* Clone = M1->clone();
+  Symbol& Copy = M1->ownSymbol(*F);
+  renameSymbol(*M1, Copy, "copy");
+  M1->notifyObservers();
+  ASSERT_NE(&Copy, F);
+  ASSERT_EQ(boost::size(Ir->findGlobalSymbols("copy")), 1);
+  EXPECT_EQ(&*Ir->findGlobalSymbols("copy").begin(), &Copy);
+  EXPECT_EQ(&*Ir->findGlobalSymbols("f").begin(), G);
+  EXPECT_EQ(&*Clone->findSymbols("f").begin(), F);
+}
+
+TEST(Unit_IR, findGlobalSymbolsInClones) {
+  auto* Ir = IR::Create(Ctx);
+  auto* M = Module::Create(Ctx);
+  auto* F = emplaceSymbol(*M, Ctx, Addr(1), "f");
+  Module* Clone = M->clone();
+  auto* Between = Module::Create(Ctx);
+  auto* G = emplaceSymbol(*Between, Ctx, Addr(2), "g");
+  Ir->addModule({M, Between, Clone});
+  Ir->indexSymbols();
+  EXPECT_EQ(boost::size(Ir->findGlobalSymbols("f")), 2);
+
+  // Renaming a shared symbol in the clone renames it in both modules.
+  renameSymbol(*Clone, *F, "g");
+  M->notifyObservers();
+  Clone->notifyObservers();
+  EXPECT_TRUE(Ir->findGlobalSymbols("f").empty());
+  auto Found = Ir->findGlobalSymbols("g");
+  ASSERT_EQ(boost::size(Found), 3);
+  EXPECT_EQ(&*Found.begin(), F);
+  EXPECT_EQ(&*std::next(Found.begin()), G);
+  EXPECT_EQ(&*std::next(Found.begin(), 2), F);
+
+  // Renaming the clone's own copy leaves the original indexed.
+  Symbol& Copy = Clone->ownSymbol(*F);
+  renameSymbol(*Clone, Copy, "h");
+  M->notifyObservers();
+  Clone->notifyObservers();
+  Found = Ir->findGlobalSymbols("g");
+  ASSERT_EQ(boost::size(Found), 2);
+  EXPECT_EQ(&*Found.begin(), F);
+  EXPECT_EQ(&*std::next(Found.begin()), G);
+  ASSERT_EQ(boost::size(Ir->findGlobalSymbols("h")), 1);
+  EXPECT_EQ(&*Ir->findGlobalSymbols("h").begin(), &Copy);
+
+  // The original can still be renamed, and is indexed once.
+  renameSymbol(*M, *F, "f");
+  M->notifyObservers();
+  Clone->notifyObservers();
+  ASSERT_EQ(boost::size(Ir->findGlobalSymbols("g")), 1);
+  EXPECT_EQ(&*Ir->findGlobalSymbols("g").begin(), G);
+  ASSERT_EQ(boost::size(Ir->findGlobalSymbols("f")), 1);
+  EXPECT_EQ(&*Ir->findGlobalSymbols("f").begin(), F);
+}
+
+TEST(Unit_IR, saveMatchesDeterministicSerialization) {
+  auto* Ir = IR::Create(Ctx);
+  for (int I = 0; I < 5; ++I) {
+    auto* M = Module::Create(Ctx);
+    M->setName("m" + std::to_string(I));
+    auto* B = emplaceBlock(M->getCFG(), Ctx, Addr(0x1000 * I), 4);
+    emplaceSymbol(*M, Ctx, B, "f" + std::to_string(I));
+    M->getImageByteMap().setAddrMinMax({Addr(0), Addr(0x10000)});
+    M->getImageByteMap().setData(Addr(0x1000 * I), 4, std::byte(I));
+    Ir->addModule(M);
+  }
+  Ir->addAuxData("b", std::vector<int64_t>{1, 2, 3});
+  Ir->addAuxData("a", std::map<Addr, uint64_t>{{Addr(1), 2}});
+
+  std::ostringstream Out;
+  Ir->save(Out);
+
+  // Serializing the whole message at once, with map entries sorted by key,
+  // gives the same bytes.
+  proto::IR Message;
+  Ir->toProtobuf(&Message);
+  std::string Expected;
+  {
+    google::protobuf::io::StringOutputStream Stream(&Expected);
+    google::protobuf::io::CodedOutputStream Coded(&Stream);
+    Coded.SetSerializationDeterministic(true);
+    Message.SerializeToCodedStream(&Coded);
+  }
+  EXPECT_EQ(Out.str(), Expected);
+
+  Context LoadCtx;
+  std::istringstream In(Out.str());
+  auto* Loaded = IR::load(LoadCtx, In);
+  ASSERT_EQ(std::distance(Loaded->begin(), Loaded->end()), 5);
+  EXPECT_EQ(std::next(Loaded->begin(), 3)->getName(), "m3");
+  EXPECT_EQ(Loaded->getAuxDataSize(), 2);
+}
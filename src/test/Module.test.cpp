@@ -15,6 +15,7 @@
 #include <gtirb/Block.hpp>
 #include <gtirb/Context.hpp>
 #include <gtirb/DataObject.hpp>
+#include <gtirb/FrozenModule.hpp>
 #include <gtirb/ImageByteMap.hpp>
 #include <gtirb/Module.hpp>
 #include <gtirb/Section.hpp>
@@ -24,13 +25,24 @@
 #include <algorithm>
 #include <gtest/gtest.h>
 #include <iterator>
+#include <set>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 using namespace gtirb;
 
 static Context Ctx;
 
+// The order of symbols sharing a name is unspecified, so compare them as sets.
+template <typename RangeT>
+static std::set<const Symbol*> symbolSet(const RangeT& R) {
+  std::set<const Symbol*> Result;
+  for (const auto& S : R)
+    Result.insert(&S);
+  return Result;
+}
+
 TEST(Unit_Module, ctor_0) { EXPECT_NE(Module::Create(Ctx), nullptr); }
 
 TEST(Unit_Module, setBinaryPath) {
@@ -251,6 +263,34 @@ TEST(Unit_Module, findSymbols) {
   }
 }
 
+TEST(Unit_Module, findSymbolsByPrefix) {
+  auto* M = Module::Create(Ctx);
+  auto* S1 = emplaceSymbol(*M, Ctx, Addr(1), "_ZN3foo3barEv");
+  auto* S2 = emplaceSymbol(*M, Ctx, Addr(2), "_ZN3foo3bazEv");
+  auto* S3 = emplaceSymbol(*M, Ctx, Addr(3), "_ZN3quxEv");
+  emplaceSymbol(*M, Ctx, Addr(4), "_Z");
+  emplaceSymbol(*M, Ctx, Addr(5), "main");
+
+  {
+    auto F = M->findSymbolsByPrefix("_ZN3foo");
+    EXPECT_EQ(std::distance(F.begin(), F.end()), 2);
+    EXPECT_EQ(&*F.begin(), S1);
+    EXPECT_EQ(&*std::next(F.begin(), 1), S2);
+  }
+
+  {
+    auto F = M->findSymbolsByPrefix("_ZN");
+    EXPECT_EQ(std::distance(F.begin(), F.end()), 3);
+    EXPECT_EQ(&*std::next(F.begin(), 2), S3);
+  }
+
+  EXPECT_EQ(std::distance(M->findSymbolsByPrefix("").begin(),
+                          M->findSymbolsByPrefix("").end()),
+            5);
+  EXPECT_TRUE(M->findSymbolsByPrefix("_ZN4").empty());
+  EXPECT_TRUE(M->findSymbolsByPrefix("mainx").empty());
+}
+
 TEST(Unit_Module, symbolWithoutAddr) {
   auto* M = Module::Create(Ctx);
   emplaceSymbol(*M, Ctx, "test");
@@ -342,6 +382,59 @@ TEST(Unit_Module, setReferent) {
   }
 }
 
+TEST(Unit_Module, findSymbolsByReferentAddress) {
+  auto* M = Module::Create(Ctx);
+  auto* D = DataObject::Create(Ctx, Addr(0x10), 4);
+  auto* B = emplaceBlock(M->getCFG(), Ctx, Addr(0x20), 1);
+  auto* S1 = emplaceSymbol(*M, Ctx, D, "data");
+  auto* S2 = emplaceSymbol(*M, Ctx, B, "code");
+  emplaceSymbol(*M, Ctx, "extern");
+
+  {
+    auto F = M->findSymbols(Addr(0x10), Addr(0x30));
+    EXPECT_EQ(std::distance(F.begin(), F.end()), 2);
+    EXPECT_EQ(&*F.begin(), S1);
+    EXPECT_EQ(&*std::next(F.begin(), 1), S2);
+  }
+
+  // Pointing a symbol at a different referent updates its address key.
+  setReferent(*M, *S1, B);
+  EXPECT_TRUE(M->findSymbols(Addr(0x10)).empty());
+  EXPECT_EQ(std::distance(M->findSymbols(Addr(0x20)).begin(),
+                          M->findSymbols(Addr(0x20)).end()),
+            2);
+}
+
+TEST(Unit_Module, symbolsFor) {
+  auto* M = Module::Create(Ctx);
+  auto* B1 = emplaceBlock(M->getCFG(), Ctx, Addr(1), 1);
+  auto* B2 = emplaceBlock(M->getCFG(), Ctx, Addr(2), 1);
+  auto* D = DataObject::Create(Ctx, Addr(1), 4);
+  auto* S1 = emplaceSymbol(*M, Ctx, B1, "b1");
+  auto* S2 = emplaceSymbol(*M, Ctx, B1, "b1_alias");
+  auto* S3 = emplaceSymbol(*M, Ctx, D, "d");
+  std::vector<Symbol*> Syms = {Symbol::Create(Ctx, B2, "b2"),
+                               Symbol::Create(Ctx, Addr(1), "addr")};
+  M->addSymbol(Syms.begin(), Syms.end());
+
+  EXPECT_EQ(symbolSet(M->symbolsFor(*B1)),
+            (std::set<const Symbol*>{S1, S2}));
+  EXPECT_EQ(symbolSet(M->symbolsFor(*B2)), (std::set<const Symbol*>{Syms[0]}));
+  EXPECT_EQ(symbolSet(M->symbolsFor(*D)), (std::set<const Symbol*>{S3}));
+
+  // The index follows changes to a symbol's referent.
+  setReferent(*M, *S2, D);
+  EXPECT_EQ(symbolSet(M->symbolsFor(*B1)), (std::set<const Symbol*>{S1}));
+  EXPECT_EQ(symbolSet(M->symbolsFor(*D)), (std::set<const Symbol*>{S2, S3}));
+
+  setSymbolAddress(*M, *S1, Addr(1));
+  EXPECT_TRUE(M->symbolsFor(*B1).empty());
+
+  const Module& CM = *M;
+  EXPECT_EQ(std::distance(CM.symbolsFor(*D).begin(), CM.symbolsFor(*D).end()),
+            2);
+}
+
 TEST(Unit_Module, setSymbolAddress) {
   auto* M = Module::Create(Ctx);
   auto* B1 = emplaceBlock(M->getCFG(), Ctx, Addr(1), 1);
@@ -448,6 +541,95 @@ TEST(Unit_Module, getAddrsForSymbolicExpression) {
   }
 }
 
+TEST(Unit_Module, getSymbolicExpressionAddrs) {
+  auto* M = Module::Create(Ctx);
+  auto* S1 = Symbol::Create(Ctx, Addr(1), "foo");
+  auto* S2 = Symbol::Create(Ctx, Addr(5), "bar");
+  auto* S3 = Symbol::Create(Ctx, Addr(10), "baz");
+
+  M->addSymbolicExpression(Addr(1), SymAddrConst{0, S1});
+  M->addSymbolicExpression(Addr(2), SymAddrConst{8, S1});
+  M->addSymbolicExpression(Addr(3), SymStackConst{4, S2});
+  M->addSymbolicExpression(Addr(4), SymAddrAddr{1, 0, S1, S2});
+  M->addSymbolicExpression(Addr(5), SymAddrAddr{1, 0, S2, S2});
+  // Ignored: an expression is already registered at this address.
+  M->addSymbolicExpression(Addr(1), SymAddrConst{0, S3});
+
+  auto AddrsOf = [M](const Symbol* S) {
+    auto R = M->getSymbolicExpressionAddrs(*S);
+    return std::set<Addr>(R.begin(), R.end());
+  };
+  EXPECT_EQ(AddrsOf(S1), (std::set<Addr>{Addr(1), Addr(2), Addr(4)}));
+  EXPECT_EQ(AddrsOf(S2), (std::set<Addr>{Addr(3), Addr(4), Addr(5)}));
+  EXPECT_TRUE(AddrsOf(S3).empty());
+
+  std::vector<std::pair<Addr, SymbolicExpression>> Exprs = {
+      {Addr(7), SymAddrConst{0, S3}}, {Addr(5), SymAddrConst{0, S3}}};
+  M->addSymbolicExpression(Exprs.begin(), Exprs.end());
+  EXPECT_EQ(AddrsOf(S3), (std::set<Addr>{Addr(7)}));
+  EXPECT_EQ(AddrsOf(S2), (std::set<Addr>{Addr(3), Addr(4), Addr(5)}));
+}
+
+TEST(Unit_Module, bulkInsertion) {
+  auto* M = Module::Create(Ctx);
+  auto* Existing = emplaceSymbol(*M, Ctx, Addr(3), "existing");
+
+  // Inputs are deliberately unsorted and overlap existing contents.
+  std::vector<Symbol*> Syms = {Symbol::Create(Ctx, Addr(5), "c"),
+                               Symbol::Create(Ctx, Addr(1), "a"),
+                               Symbol::Create(Ctx, "b"),
+                               Symbol::Create(Ctx, Addr(3), "a")};
+  M->addSymbol(Syms.begin(), Syms.end());
+  {
+    auto F = M->findSymbols(Addr(0), Addr(10));
+    ASSERT_EQ(std::distance(F.begin(), F.end()), 4);
+    EXPECT_EQ(&*F.begin(), Syms[1]);
+    EXPECT_EQ(&*std::next(F.begin(), 1), Existing);
+    EXPECT_EQ(&*std::next(F.begin(), 2), Syms[3]);
+    EXPECT_EQ(&*std::next(F.begin(), 3), Syms[0]);
+    EXPECT_EQ(symbolSet(M->findSymbols("a")),
+              (std::set<const Symbol*>{Syms[1], Syms[3]}));
+    EXPECT_EQ(&*M->findSymbols("b").begin(), Syms[2]);
+  }
+
+  std::vector<DataObject*> Data = {DataObject::Create(Ctx, Addr(5), 10),
+                                   DataObject::Create(Ctx, Addr(1), 20)};
+  M->addData(Data.begin(), Data.end());
+  {
+    auto F = M->findData(Addr(14));
+    EXPECT_EQ(std::distance(F.begin(), F.end()), 2);
+    F = M->findData(Addr(20));
+    EXPECT_EQ(std::distance(F.begin(), F.end()), 1);
+    EXPECT_EQ(&*F.begin(), Data[1]);
+    EXPECT_TRUE(M->findData(Addr(21)).empty());
+  }
+
+  std::vector<Section*> Secs = {Section::Create(Ctx, "b", Addr(20), 10),
+                                Section::Create(Ctx, "a", Addr(10), 10)};
+  M->addSection(Secs.begin(), Secs.end());
+  EXPECT_EQ(&*M->findSection(Addr(10)), Secs[1]);
+  EXPECT_EQ(&*M->findSection(Addr(20)), Secs[0]);
+  EXPECT_EQ(&*M->section_begin(), Secs[1]);
+
+  M->addSymbolicExpression(Addr(4), SymAddrConst{0, Existing});
+  std::vector<std::pair<Addr, SymbolicExpression>> Exprs = {
+      {Addr(8), SymAddrConst{0, Syms[0]}},
+      {Addr(2), SymAddrConst{0, Syms[1]}},
+      {Addr(4), SymAddrConst{0, Syms[2]}}};
+  M->addSymbolicExpression(Exprs.begin(), Exprs.end());
+  {
+    auto F = M->findSymbolicExpression(Addr(0), Addr(10));
+    ASSERT_EQ(std::distance(F.begin(), F.end()), 3);
+    EXPECT_EQ(std::get<SymAddrConst>(*F.begin()).Sym, Syms[1]);
+    // An address already holding an expression keeps it.
+    EXPECT_EQ(std::get<SymAddrConst>(*std::next(F.begin(), 1)).Sym, Existing);
+    EXPECT_EQ(std::get<SymAddrConst>(*std::next(F.begin(), 2)).Sym, Syms[0]);
+    EXPECT_EQ(*M->getAddrsForSymbolicExpression(SymAddrConst{0, Syms[0]})
+                   .begin(),
+              Addr(8));
+  }
+}
+
 TEST(Unit_Module, protobufRoundTrip) {
   proto::Module Message;
 
@@ -566,3 +748,468 @@ TEST(Unit_Module, protobufNodePointers) {
   EXPECT_EQ(get<SymAddrConst>(*Result->findSymbolicExpression(Addr(4))).Sym,
             nullptr);
 }
+
+TEST(Unit_Module, clone) {
+  auto* Original = Module::Create(Ctx);
+  Original->setName("original");
+  Original->setISAID(ISAID::X64);
+  auto* B1 = emplaceBlock(Original->getCFG(), Ctx, Addr(1), 2);
+  auto* B2 = emplaceBlock(Original->getCFG(), Ctx, Addr(3), 2);
+  addEdge(B1, B2, Original->getCFG());
+  auto* Data = DataObject::Create(Ctx, Addr(8), 4);
+  Original->addData(Data);
+  Original->addSection(Section::Create(Ctx, ".text", Addr(1), 4));
+  auto* Sym = emplaceSymbol(*Original, Ctx, B1, "sym");
+  Original->addSymbolicExpression(Addr(2), SymAddrConst{0, Sym});
+  auto& IBM = Original->getImageByteMap();
+  IBM.setAddrMinMax({Addr(1), Addr(12)});
+  std::vector<std::byte> Bytes{std::byte(1), std::byte(2), std::byte(3)};
+  IBM.setData(Addr(1), gsl::span<const std::byte>(Bytes));
+
+  const Module* Clone = Original->clone();
+  EXPECT_NE(Clone->getUUID(), Original->getUUID());
+  EXPECT_NE(Clone->getImageByteMap().getUUID(), IBM.getUUID());
+  EXPECT_EQ(Clone->getName(), "original");
+  EXPECT_EQ(Clone->getISAID(), ISAID::X64);
+  EXPECT_EQ(num_vertices(Clone->getCFG()), 2);
+  EXPECT_EQ(num_edges(Clone->getCFG()), 1);
+  EXPECT_EQ(&*Clone->findData(Addr(8)).begin(), Data);
+  EXPECT_EQ(Clone->findSection(Addr(1))->getName(), ".text");
+  EXPECT_EQ(&*Clone->findSymbols("sym").begin(), Sym);
+  EXPECT_EQ(get<SymAddrConst>(*Clone->findSymbolicExpression(Addr(2))).Sym,
+            Sym);
+  EXPECT_EQ(Clone->getImageByteMap().getAddrMinMax(),
+            std::make_pair(Addr(1), Addr(12)));
+  auto Range = Clone->getImageByteMap().data(Addr(1), 3);
+  EXPECT_TRUE(std::equal(Range.begin(), Range.end(), Bytes.begin()));
+  // Reading the bytes of the clone does not copy them.
+  EXPECT_EQ(&*Range.begin(), &*IBM.data(Addr(1), 3).begin());
+}
+
+TEST(Unit_Module, cloneCopiesOnWrite) {
+  auto* Original = Module::Create(Ctx);
+  auto* B1 = emplaceBlock(Original->getCFG(), Ctx, Addr(1), 2);
+  auto* B2 = emplaceBlock(Original->getCFG(), Ctx, Addr(3), 2);
+  auto* Sym = emplaceSymbol(*Original, Ctx, B1, "sym");
+  auto* Other = emplaceSymbol(*Original, Ctx, B2, "other");
+  Original->addSymbolicExpression(Addr(2), SymAddrAddr{1, 0, Sym, Other});
+  Original->addSymbolicExpression(Addr(4), SymAddrConst{0, Sym});
+  auto& IBM = Original->getImageByteMap();
+  IBM.setAddrMinMax({Addr(1), Addr(3)});
+  std::vector<std::byte> Bytes{std::byte(1), std::byte(2)};
+  IBM.setData(Addr(1), gsl::span<const std::byte>(Bytes));
+
+  Module* Clone = Original->clone();
+
+  // Changing a shared symbol changes it in both modules.
+  renameSymbol(*Clone, *Sym, "shared");
+  EXPECT_EQ(Sym->getName(), "shared");
+  EXPECT_EQ(&*Clone->findSymbols("shared").begin(), Sym);
+  EXPECT_EQ(&*Original->findSymbols("shared").begin(), Sym);
+  EXPECT_TRUE(Original->findSymbols("sym").empty());
+  setSymbolAddress(*Original, *Sym, Addr(8));
+  EXPECT_EQ(&*Clone->findSymbols(Addr(8)).begin(), Sym);
+  EXPECT_TRUE(Clone->findSymbols(Addr(1)).empty());
+  setReferent(*Clone, *Sym, B1);
+  EXPECT_EQ(&*Original->findSymbols(Addr(1)).begin(), Sym);
+  renameSymbol(*Original, *Sym, "sym");
+
+  // Owning a shared symbol first changes a copy of it in one module only.
+  Symbol& Renamed = Clone->ownSymbol(*Sym);
+  EXPECT_NE(&Renamed, Sym);
+  renameSymbol(*Clone, Renamed, "renamed");
+  EXPECT_NE(Renamed.getUUID(), Sym->getUUID());
+  EXPECT_EQ(Renamed.getName(), "renamed");
+  EXPECT_EQ(Renamed.getReferent<Block>(), B1);
+  EXPECT_EQ(Sym->getName(), "sym");
+  EXPECT_EQ(&*Clone->findSymbols("renamed").begin(), &Renamed);
+  EXPECT_TRUE(Clone->findSymbols("sym").empty());
+  EXPECT_EQ(&*Original->findSymbols("sym").begin(), Sym);
+  EXPECT_TRUE(Original->findSymbols("renamed").empty());
+
+  // The clone's symbolic expressions refer to the copy.
+  auto& Diff = get<SymAddrAddr>(*Clone->findSymbolicExpression(Addr(2)));
+  EXPECT_EQ(Diff.Sym1, &Renamed);
+  EXPECT_EQ(Diff.Sym2, Other);
+  EXPECT_EQ(get<SymAddrConst>(*Clone->findSymbolicExpression(Addr(4))).Sym,
+            &Renamed);
+  EXPECT_EQ(get<SymAddrConst>(*Original->findSymbolicExpression(Addr(4))).Sym,
+            Sym);
+  EXPECT_EQ(boost::size(Clone->getSymbolicExpressionAddrs(Renamed)), 2);
+  EXPECT_EQ(boost::size(Clone->getSymbolicExpressionAddrs(*Sym)), 0);
+  EXPECT_EQ(boost::size(Original->getSymbolicExpressionAddrs(*Sym)), 2);
+
+  // Once copied, the symbol is owned and is changed in place.
+  EXPECT_EQ(&Clone->ownSymbol(Renamed), &Renamed);
+  setSymbolAddress(*Clone, Renamed, Addr(7));
+  EXPECT_EQ(&*Clone->findSymbols(Addr(7)).begin(), &Renamed);
+  EXPECT_TRUE(Original->findSymbols(Addr(7)).empty());
+
+  // The original can own its shared symbols too.
+  Symbol& Moved = Original->ownSymbol(*Other);
+  EXPECT_NE(&Moved, Other);
+  setReferent(*Original, Moved, B1);
+  EXPECT_EQ(Other->getReferent<Block>(), B2);
+  EXPECT_EQ(&*Clone->findSymbols("other").begin(), Other);
+  EXPECT_EQ(&*Original->findSymbols("other").begin(), &Moved);
+
+  // Symbols added after cloning are not shared.
+  auto* Added = emplaceSymbol(*Clone, Ctx, Addr(9), "added");
+  EXPECT_EQ(&Clone->ownSymbol(*Added), Added);
+  EXPECT_TRUE(Original->findSymbols("added").empty());
+
+  // Reading the CFG of a non-const module does not copy it.
+  EXPECT_EQ(&Clone->readCFG(), &Original->readCFG());
+
+  // Other containers and byte map regions are copied when they change.
+  auto* B3 = emplaceBlock(Clone->getCFG(), Ctx, Addr(5), 2);
+  addEdge(B2, B3, Clone->getCFG());
+  EXPECT_EQ(num_vertices(Clone->getCFG()), 3);
+  EXPECT_EQ(num_vertices(Original->getCFG()), 2);
+  EXPECT_EQ(num_edges(Original->getCFG()), 0);
+  Clone->addData(DataObject::Create(Ctx, Addr(8), 4));
+  EXPECT_TRUE(Original->findData(Addr(8)).empty());
+  Clone->addSection(Section::Create(Ctx, ".data", Addr(8), 4));
+  EXPECT_TRUE(Original->findSection(Addr(8)) == Original->section_end());
+
+  std::vector<std::byte> Patch{std::byte(9)};
+  Clone->getImageByteMap().setData(Addr(2), gsl::span<const std::byte>(Patch));
+  EXPECT_EQ(*Clone->getImageByteMap().data(Addr(2), 1).begin(), std::byte(9));
+  EXPECT_EQ(*IBM.data(Addr(2), 1).begin(), std::byte(2));
+}
+
+TEST(Unit_Module, blockColumns) {
+  auto* M = Module::Create(Ctx);
+  EXPECT_TRUE(M->blockColumns().empty());
+
+  auto* B1 = emplaceBlock(*M, Ctx, Addr(5), 2);
+  auto* B2 = emplaceBlock(*M, Ctx, Addr(1), 2);
+  const BlockColumns& Columns = M->blockColumns();
+  ASSERT_EQ(Columns.size(), 2);
+  EXPECT_EQ(&Columns.block(0), B2);
+  EXPECT_EQ(&Columns.block(1), B1);
+  // The columns are kept until the CFG may change.
+  EXPECT_EQ(&M->blockColumns(), &Columns);
+
+  // A clone and a snapshot share them.
+  auto* Clone = M->clone();
+  EXPECT_EQ(&Clone->blockColumns(), &Columns);
+  EXPECT_EQ(&M->freeze().blockColumns(), &Columns);
+
+  // Adding a block rebuilds them for this module only.
+  auto* B3 = emplaceBlock(*M, Ctx, Addr(3), 2);
+  ASSERT_EQ(M->blockColumns().size(), 3);
+  EXPECT_EQ(M->blockColumns().indexOf(*B3), 1);
+  EXPECT_EQ(Clone->blockColumns().size(), 2);
+  EXPECT_EQ(Clone->blockColumns().indexOf(*B3), std::nullopt);
+
+  // As does any access to the CFG which may change it.
+  emplaceBlock(Clone->getCFG(), Ctx, Addr(9), 2);
+  EXPECT_EQ(Clone->blockColumns().size(), 3);
+}
+
+TEST(Unit_Module, transactionRollback) {
+  auto* M = Module::Create(Ctx);
+  auto& Cfg = M->getCFG();
+  auto* B1 = emplaceBlock(Cfg, Ctx, Addr(1), 2);
+  auto* B2 = emplaceBlock(Cfg, Ctx, Addr(3), 2);
+  Cfg[addEdge(B1, B2, Cfg)] = true;
+  auto* Data = DataObject::Create(Ctx, Addr(8), 4);
+  M->addData(Data);
+  M->addSection(Section::Create(Ctx, ".text", Addr(1), 4));
+  auto* Sym = emplaceSymbol(*M, Ctx, B1, "sym");
+  auto* Other = emplaceSymbol(*M, Ctx, Addr(20), "other");
+  M->addSymbolicExpression(Addr(2), SymAddrConst{0, Sym});
+  auto& IBM = M->getImageByteMap();
+  IBM.setAddrMinMax({Addr(0), Addr(64)});
+  std::vector<std::byte> Low{std::byte(1), std::byte(2), std::byte(3)};
+  std::vector<std::byte> High{std::byte(4), std::byte(5)};
+  IBM.setData(Addr(10), gsl::span<const std::byte>(Low));
+  IBM.setData(Addr(15), gsl::span<const std::byte>(High));
+  AddrRangeSet Ranges = IBM.addressRanges();
+
+  M->beginTransaction();
+  EXPECT_TRUE(M->inTransaction());
+  auto* Added = emplaceSymbol(*M, Ctx, Addr(30), "added");
+  renameSymbol(*M, *Sym, "renamed");
+  setSymbolAddress(*M, *Sym, Addr(40));
+  setReferent(*M, *Other, Data);
+  M->addData(DataObject::Create(Ctx, Addr(10), 4));
+  M->addSection({Section::Create(Ctx, ".data", Addr(8), 4)});
+  M->addSymbolicExpression(Addr(3), SymAddrAddr{1, 0, Added, Sym});
+  std::vector<std::byte> Patch{std::byte(9), std::byte(9)};
+  IBM.setData(Addr(11), gsl::span<const std::byte>(Patch)); // Overwrite
+  IBM.setData(Addr(13), gsl::span<const std::byte>(Patch)); // Append, merge
+  IBM.setData(Addr(8), gsl::span<const std::byte>(Patch));  // Prepend
+  IBM.setData(Addr(30), gsl::span<const std::byte>(Patch)); // New region
+  auto* B3 = emplaceBlock(*M, Ctx, Addr(5), 2);
+  addEdge(B2, B3, *M);
+  addEdge(B2, B1, *M);
+  EXPECT_TRUE(removeEdge(B1, B2, *M));
+  EXPECT_FALSE(removeEdge(B1, B2, *M));
+  EXPECT_EQ(IBM.addressRanges().ranges().size(), 2);
+  M->rollbackTransaction();
+  EXPECT_FALSE(M->inTransaction());
+
+  EXPECT_TRUE(M->findSymbols("added").empty());
+  EXPECT_TRUE(M->findSymbols("renamed").empty());
+  EXPECT_EQ(&*M->findSymbols("sym").begin(), Sym);
+  EXPECT_EQ(Sym->getName(), "sym");
+  EXPECT_EQ(Sym->getReferent<Block>(), B1);
+  EXPECT_EQ(&*M->findSymbols(Addr(1)).begin(), Sym);
+  EXPECT_TRUE(M->findSymbols(Addr(40)).empty());
+  EXPECT_EQ(Other->getAddress(), Addr(20));
+  EXPECT_EQ(&*M->findSymbols(Addr(20)).begin(), Other);
+  EXPECT_TRUE(M->symbolsFor(*Data).empty());
+  EXPECT_EQ(boost::size(M->symbols()), 2);
+
+  EXPECT_EQ(boost::size(M->data()), 1);
+  EXPECT_EQ(boost::size(M->findData(Addr(10))), 1);
+  EXPECT_EQ(boost::size(M->sections()), 1);
+  EXPECT_EQ(boost::size(M->symbolic_exprs()), 1);
+  EXPECT_TRUE(M->findSymbolicExpression(Addr(3)) == M->symbolic_expr_end());
+  EXPECT_EQ(boost::size(M->getSymbolicExpressionAddrs(*Sym)), 1);
+  EXPECT_EQ(boost::size(M->getSymbolicExpressionAddrs(*Added)), 0);
+
+  EXPECT_TRUE(IBM.addressRanges() == Ranges);
+  auto LowBytes = IBM.data(Addr(10), 3);
+  EXPECT_TRUE(std::equal(LowBytes.begin(), LowBytes.end(), Low.begin()));
+  auto HighBytes = IBM.data(Addr(15), 2);
+  EXPECT_TRUE(std::equal(HighBytes.begin(), HighBytes.end(), High.begin()));
+
+  EXPECT_EQ(num_vertices(Cfg), 2);
+  EXPECT_EQ(num_edges(Cfg), 1);
+  EXPECT_EQ(source(*edges(Cfg).first, Cfg), B1->getVertex());
+  EXPECT_EQ(target(*edges(Cfg).first, Cfg), B2->getVertex());
+  EXPECT_EQ(Cfg[*edges(Cfg).first], EdgeLabel(true));
+}
+
+TEST(Unit_Module, transactionCommit) {
+  auto* M = Module::Create(Ctx);
+  auto* Sym = emplaceSymbol(*M, Ctx, Addr(1), "sym");
+
+  M->beginTransaction();
+  renameSymbol(*M, *Sym, "renamed");
+  emplaceSymbol(*M, Ctx, Addr(2), "kept");
+  M->commitTransaction();
+  EXPECT_FALSE(M->inTransaction());
+  EXPECT_EQ(Sym->getName(), "renamed");
+  EXPECT_EQ(boost::size(M->findSymbols("kept")), 1);
+
+  // Nothing is recorded outside of a transaction.
+  M->beginTransaction();
+  M->rollbackTransaction();
+  EXPECT_EQ(Sym->getName(), "renamed");
+  EXPECT_EQ(boost::size(M->findSymbols("kept")), 1);
+}
+
+TEST(Unit_Module, nestedTransactions) {
+  auto* M = Module::Create(Ctx);
+  M->beginTransaction();
+  emplaceSymbol(*M, Ctx, Addr(1), "outer");
+
+  M->beginTransaction();
+  emplaceSymbol(*M, Ctx, Addr(2), "rolledBack");
+  M->rollbackTransaction();
+  EXPECT_TRUE(M->inTransaction());
+  EXPECT_TRUE(M->findSymbols("rolledBack").empty());
+  EXPECT_EQ(boost::size(M->findSymbols("outer")), 1);
+
+  M->beginTransaction();
+  emplaceSymbol(*M, Ctx, Addr(3), "committed");
+  M->commitTransaction();
+  EXPECT_EQ(boost::size(M->findSymbols("committed")), 1);
+
+  // Rolling back the outer transaction undoes the committed inner one.
+  M->rollbackTransaction();
+  EXPECT_TRUE(M->symbols().empty());
+}
+
+TEST(Unit_Module, transactionOnClone) {
+  auto* Original = Module::Create(Ctx);
+  auto* Sym = emplaceSymbol(*Original, Ctx, Addr(1), "sym");
+  Original->addSymbolicExpression(Addr(2), SymAddrConst{0, Sym});
+  Module* Clone = Original->clone();
+
+  Clone->beginTransaction();
+  Symbol& Copy = Clone->ownSymbol(*Sym);
+  renameSymbol(*Clone, Copy, "renamed");
+  EXPECT_NE(&Copy, Sym);
+  Clone->rollbackTransaction();
+
+  EXPECT_EQ(&*Clone->findSymbols("sym").begin(), Sym);
+  EXPECT_TRUE(Clone->findSymbols("renamed").empty());
+  EXPECT_EQ(Copy.getName(), "sym");
+  EXPECT_EQ(get<SymAddrConst>(*Clone->findSymbolicExpression(Addr(2))).Sym,
+            Sym);
+  EXPECT_EQ(boost::size(Clone->getSymbolicExpressionAddrs(*Sym)), 1);
+
+  // Rolling back a change to a shared symbol restores it in both modules.
+  Original->beginTransaction();
+  renameSymbol(*Original, *Sym, "renamed");
+  EXPECT_EQ(&*Clone->findSymbols("renamed").begin(), Sym);
+  Original->rollbackTransaction();
+  EXPECT_EQ(&*Clone->findSymbols("sym").begin(), Sym);
+  EXPECT_EQ(&*Original->findSymbols("sym").begin(), Sym);
+  EXPECT_TRUE(Clone->findSymbols("renamed").empty());
+}
+
+TEST(Unit_Module, cloneSharesSymbols) {
+  auto* Original = Module::Create(Ctx);
+  auto* Sym = emplaceSymbol(*Original, Ctx, Addr(1), "sym");
+  Module* Clone = Original->clone();
+  // Adding to the clone copies its container, but not the symbol.
+  auto* Added = emplaceSymbol(*Clone, Ctx, Addr(2), "added");
+  EXPECT_EQ(&Clone->ownSymbol(*Added), Added);
+  renameSymbol(*Clone, *Sym, "renamed");
+  EXPECT_EQ(&*Original->findSymbols("renamed").begin(), Sym);
+  EXPECT_EQ(&*Clone->findSymbols("renamed").begin(), Sym);
+  EXPECT_TRUE(Original->findSymbols("sym").empty());
+  EXPECT_TRUE(Clone->findSymbols("sym").empty());
+
+  // Clones of clones share the symbol too.
+  Module* Second = Clone->clone();
+  setSymbolAddress(*Second, *Sym, Addr(3));
+  EXPECT_EQ(&*Original->findSymbols(Addr(3)).begin(), Sym);
+  EXPECT_EQ(&*Clone->findSymbols(Addr(3)).begin(), Sym);
+  EXPECT_TRUE(Original->findSymbols(Addr(1)).empty());
+}
+
+namespace {
+class RecordingObserver : public ModuleObserver {
+public:
+  void changed(const Module&, gsl::span<const ModuleChange> Cs) override {
+    Batches.emplace_back(Cs.begin(), Cs.end());
+  }
+
+  std::vector<std::vector<ModuleChange>> Batches;
+};
+} // namespace
+
+TEST(Unit_Module, observerBatches) {
+  auto* M = Module::Create(Ctx);
+  RecordingObserver O;
+  M->addObserver(O);
+  M->notifyObservers();
+  EXPECT_TRUE(O.Batches.empty());
+
+  auto* Sym = emplaceSymbol(*M, Ctx, Addr(1), "sym");
+  auto* D = DataObject::Create(Ctx, Addr(2), 4);
+  M->addData(D);
+  M->addSymbolicExpression(Addr(3), SymAddrConst{0, Sym});
+  M->notifyObservers();
+  ASSERT_EQ(O.Batches.size(), 1);
+  const auto& Batch = O.Batches[0];
+  ASSERT_EQ(Batch.size(), 3);
+  EXPECT_EQ(Batch[0].What, ModuleChange::Kind::SymbolAdded);
+  EXPECT_EQ(Batch[0].Item, Sym);
+  EXPECT_EQ(Batch[1].What, ModuleChange::Kind::DataAdded);
+  EXPECT_EQ(Batch[1].Item, D);
+  EXPECT_EQ(Batch[2].What, ModuleChange::Kind::SymbolicExpressionAdded);
+  EXPECT_EQ(Batch[2].Address, Addr(3));
+
+  // Delivered changes are not delivered again.
+  M->notifyObservers();
+  EXPECT_EQ(O.Batches.size(), 1);
+
+  M->removeObserver(O);
+  emplaceSymbol(*M, Ctx, Addr(4), "unobserved");
+  M->notifyObservers();
+  EXPECT_EQ(O.Batches.size(), 1);
+}
+
+TEST(Unit_Module, observerCFGAndBytes) {
+  auto* M = Module::Create(Ctx);
+  auto& IBM = M->getImageByteMap();
+  IBM.setAddrMinMax({Addr(0x1000), Addr(0x2000)});
+  auto* Existing = emplaceBlock(M->getCFG(), Ctx, Addr(0x1000), 2);
+  RecordingObserver O;
+  M->addObserver(O);
+
+  auto* B = emplaceBlock(*M, Ctx, Addr(0x1002), 2);
+  addEdge(Existing, B, *M);
+  std::vector<std::byte> Bytes(4);
+  IBM.setData(Addr(0x1000), gsl::span<const std::byte>(Bytes));
+  IBM.setData(Addr(0x1004), gsl::span<const std::byte>(Bytes));
+  IBM.setData(Addr(0x1002), gsl::span<const std::byte>(Bytes).first(2));
+  M->notifyObservers();
+
+  ASSERT_EQ(O.Batches.size(), 1);
+  const auto& Batch = O.Batches[0];
+  ASSERT_EQ(Batch.size(), 3);
+  EXPECT_EQ(Batch[0].What, ModuleChange::Kind::BlockAdded);
+  EXPECT_EQ(Batch[0].Item, B);
+  EXPECT_EQ(Batch[1].What, ModuleChange::Kind::EdgeAdded);
+  EXPECT_EQ(Batch[1].Item, Existing);
+  EXPECT_EQ(Batch[1].Target, B);
+  // Adjacent and overlapping writes are coalesced.
+  EXPECT_EQ(Batch[2].What, ModuleChange::Kind::BytesChanged);
+  EXPECT_EQ(Batch[2].Address, Addr(0x1000));
+  EXPECT_EQ(Batch[2].Size, 8);
+  M->removeObserver(O);
+}
+
+TEST(Unit_Module, observerRollback) {
+  auto* M = Module::Create(Ctx);
+  auto* Sym = emplaceSymbol(*M, Ctx, Addr(1), "sym");
+  auto* Existing = emplaceBlock(M->getCFG(), Ctx, Addr(0x1000), 2);
+  RecordingObserver O;
+  M->addObserver(O);
+
+  M->beginTransaction();
+  auto* Added = emplaceSymbol(*M, Ctx, Addr(2), "added");
+  renameSymbol(*M, *Sym, "renamed");
+  auto* B = emplaceBlock(*M, Ctx, Addr(0x1002), 2);
+  addEdge(Existing, B, *M);
+  M->notifyObservers();
+  ASSERT_EQ(O.Batches.size(), 1);
+  EXPECT_EQ(O.Batches[0].size(), 4);
+
+  M->rollbackTransaction();
+  M->notifyObservers();
+  ASSERT_EQ(O.Batches.size(), 2);
+  const auto& Batch = O.Batches[1];
+  ASSERT_EQ(Batch.size(), 4);
+  EXPECT_EQ(Batch[0].What, ModuleChange::Kind::EdgeRemoved);
+  EXPECT_EQ(Batch[0].Item, Existing);
+  EXPECT_EQ(Batch[0].Target, B);
+  EXPECT_EQ(Batch[1].What, ModuleChange::Kind::BlockRemoved);
+  EXPECT_EQ(Batch[1].Item, B);
+  EXPECT_EQ(Batch[2].What, ModuleChange::Kind::SymbolChanged);
+  EXPECT_EQ(Batch[2].Item, Sym);
+  EXPECT_EQ(Batch[3].What, ModuleChange::Kind::SymbolRemoved);
+  EXPECT_EQ(Batch[3].Item, Added);
+  M->removeObserver(O);
+}
+
+TEST(Unit_Module, observerRemoveThenAddEdge) {
+  auto* M = Module::Create(Ctx);
+  auto* B1 = emplaceBlock(*M, Ctx, Addr(1), 2);
+  auto* B2 = emplaceBlock(*M, Ctx, Addr(3), 2);
+  auto* B3 = emplaceBlock(*M, Ctx, Addr(5), 2);
+  addEdge(B1, B2, *M);
+  RecordingObserver O;
+  M->addObserver(O);
+
+  // The number of edges is unchanged, but both changes are reported.
+  EXPECT_TRUE(removeEdge(B1, B2, *M));
+  addEdge(B1, B3, *M);
+  M->notifyObservers();
+  ASSERT_EQ(O.Batches.size(), 1);
+  const auto& Batch = O.Batches[0];
+  ASSERT_EQ(Batch.size(), 2);
+  EXPECT_EQ(Batch[0].What, ModuleChange::Kind::EdgeRemoved);
+  EXPECT_EQ(Batch[0].Item, B1);
+  EXPECT_EQ(Batch[0].Target, B2);
+  EXPECT_EQ(Batch[1].What, ModuleChange::Kind::EdgeAdded);
+  EXPECT_EQ(Batch[1].Item, B1);
+  EXPECT_EQ(Batch[1].Target, B3);
+
+  // Changes made while a module has no observers are never reported.
+  M->removeObserver(O);
+  emplaceBlock(*M, Ctx, Addr(7), 2);
+  M->addObserver(O);
+  M->notifyObservers();
+  EXPECT_EQ(O.Batches.size(), 1);
+  M->removeObserver(O);
+}
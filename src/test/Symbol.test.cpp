@@ -36,6 +36,26 @@ TEST(Unit_Symbol, setStorageKind) {
   EXPECT_EQ(Value, Node->getStorageKind());
 }
 
+TEST(Unit_Symbol, internedNames) {
+  Context LocalCtx;
+  auto* S1 = Symbol::Create(LocalCtx, "_ZNSt6vectorIiSaIiEE9push_backEOi");
+  auto* S2 = Symbol::Create(LocalCtx, "_ZNSt6vectorIiSaIiEE9push_backEOi");
+  auto* S3 = Symbol::Create(LocalCtx, "other");
+
+  // Equal names share storage within a Context.
+  EXPECT_EQ(&S1->getName(), &S2->getName());
+  EXPECT_NE(&S1->getName(), &S3->getName());
+
+  // Renaming interns the new name without affecting other symbols.
+  Module* M = Module::Create(LocalCtx);
+  M->addSymbol({S1, S2, S3});
+  renameSymbol(*M, *S3, "_ZNSt6vectorIiSaIiEE9push_backEOi");
+  EXPECT_EQ(&S1->getName(), &S3->getName());
+  renameSymbol(*M, *S1, "renamed");
+  EXPECT_EQ(S1->getName(), "renamed");
+  EXPECT_EQ(S2->getName(), "_ZNSt6vectorIiSaIiEE9push_backEOi");
+}
+
 TEST(Unit_Symbol, setReferent) {
   Module* Mod = Module::Create(Ctx);
   Symbol* Sym = emplaceSymbol(*Mod, Ctx);
@@ -0,0 +1,164 @@
+//===- Synthetic.test.cpp ---------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2018 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "SyntheticIR.hpp"
+#include <gtirb/gtirb.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gtirb;
+
+namespace {
+synthetic::Options smallOptions() {
+  synthetic::Options Opts;
+  Opts.Seed = 42;
+  Opts.Modules = 2;
+  Opts.BlocksPerModule = 200;
+  Opts.ByteMapRegions = 3;
+  Opts.AuxDataTables = 2;
+  Opts.AuxDataRows = 50;
+  return Opts;
+}
+
+std::vector<std::pair<std::string, Addr>> symbolsOf(const Module& M) {
+  std::vector<std::pair<std::string, Addr>> Result;
+  for (const auto& S : M.symbols())
+    Result.emplace_back(S.getName(), *S.getAddress());
+  return Result;
+}
+
+// The name of the section containing an address, or "" if there is none.
+std::string sectionAt(const Module& M, Addr A) {
+  for (const auto& S : M.sections())
+    if (containsAddr(S, A))
+      return S.getName();
+  return "";
+}
+
+std::vector<std::pair<Addr, uint64_t>> blocksOf(const Module& M) {
+  std::vector<std::pair<Addr, uint64_t>> Result;
+  for (const auto& B : blocks(M.getCFG()))
+    Result.emplace_back(B.getAddress(), B.getSize());
+  return Result;
+}
+} // namespace
+
+TEST(Unit_Synthetic, deterministic) {
+  Context C1, C2;
+  IR* I1 = synthetic::generateIR(C1, smallOptions());
+  IR* I2 = synthetic::generateIR(C2, smallOptions());
+  ASSERT_EQ(I1->modules().size(), I2->modules().size());
+  for (size_t M = 0; M < I1->modules().size(); ++M) {
+    EXPECT_EQ(symbolsOf(I1->modules()[M]), symbolsOf(I2->modules()[M]));
+    EXPECT_EQ(blocksOf(I1->modules()[M]), blocksOf(I2->modules()[M]));
+  }
+  EXPECT_EQ(*I1->getAuxData("synthetic1")->get<synthetic::ExtraTable>(),
+            *I2->getAuxData("synthetic1")->get<synthetic::ExtraTable>());
+
+  Context C3;
+  auto Opts = smallOptions();
+  Opts.Seed = 43;
+  IR* I3 = synthetic::generateIR(C3, Opts);
+  EXPECT_NE(blocksOf(I1->modules()[0]), blocksOf(I3->modules()[0]));
+}
+
+TEST(Unit_Synthetic, counts) {
+  Context C;
+  synthetic::Counts Counts;
+  IR* I = synthetic::generateIR(C, smallOptions(), &Counts);
+
+  synthetic::Counts Actual;
+  for (const auto& M : I->modules()) {
+    Actual.Modules += 1;
+    Actual.Blocks += num_vertices(M.getCFG());
+    Actual.Edges += num_edges(M.getCFG());
+    Actual.Symbols += boost::size(M.symbols());
+    Actual.DataObjects += boost::size(M.data());
+    Actual.SymbolicOperands += boost::size(M.symbolic_exprs());
+    for (const auto& S : M.sections())
+      Actual.Bytes += S.getSize();
+  }
+  EXPECT_EQ(Counts.Modules, 2);
+  EXPECT_EQ(Counts.Blocks, 400);
+  EXPECT_EQ(Counts.Modules, Actual.Modules);
+  EXPECT_EQ(Counts.Blocks, Actual.Blocks);
+  EXPECT_EQ(Counts.Edges, Actual.Edges);
+  EXPECT_EQ(Counts.Symbols, Actual.Symbols);
+  EXPECT_EQ(Counts.DataObjects, Actual.DataObjects);
+  EXPECT_EQ(Counts.SymbolicOperands, Actual.SymbolicOperands);
+  EXPECT_EQ(Counts.Bytes, Actual.Bytes);
+  EXPECT_EQ(Counts.nodes(), Counts.Modules + Counts.Blocks + Counts.Symbols +
+                                Counts.DataObjects);
+
+  // 200 blocks in functions of 16.
+  const auto* Functions =
+      I->getAuxData("functions")->get<synthetic::FunctionTable>();
+  ASSERT_NE(Functions, nullptr);
+  EXPECT_EQ(Functions->size(), 2 * 13);
+  const auto* Extra = I->getAuxData("synthetic0")->get<synthetic::ExtraTable>();
+  ASSERT_NE(Extra, nullptr);
+  EXPECT_EQ(Extra->size(), 50);
+}
+
+TEST(Unit_Synthetic, layout) {
+  Context C;
+  Module* M = synthetic::generateModule(C, smallOptions());
+
+  // Three code regions and one data region, each a section fully covered by
+  // the ByteMap.
+  ASSERT_EQ(boost::size(M->sections()), 4);
+  for (const auto& S : M->sections())
+    EXPECT_EQ(M->getImageByteMap().data(S.getAddress(), S.getSize()).size(),
+              S.getSize());
+
+  // Every block lies in a code section and exits consistently with its
+  // edges.
+  const auto& Cfg = M->getCFG();
+  for (auto V : boost::make_iterator_range(vertices(Cfg))) {
+    const Block* B = Cfg[V];
+    EXPECT_EQ(sectionAt(*M, B->getAddress()).substr(0, 5), ".text");
+    switch (B->getExitKind()) {
+    case Block::Exit::Return:
+      EXPECT_EQ(out_degree(V, Cfg), 0);
+      break;
+    case Block::Exit::Branch:
+      EXPECT_GE(out_degree(V, Cfg), 2);
+      break;
+    default:
+      EXPECT_GE(out_degree(V, Cfg), 1);
+    }
+  }
+  for (const auto& D : M->data())
+    EXPECT_EQ(sectionAt(*M, D.getAddress()), ".data");
+}
+
+TEST(Unit_Synthetic, saveAndLoad) {
+  Context C;
+  synthetic::Counts Counts;
+  std::stringstream Out;
+  synthetic::generateIR(C, smallOptions(), &Counts)->save(Out);
+
+  Context C2;
+  IR* Loaded = IR::load(C2, Out);
+  ASSERT_EQ(Loaded->modules().size(), 2);
+  uint64_t Blocks = 0, Symbols = 0;
+  for (const auto& M : Loaded->modules()) {
+    Blocks += num_vertices(M.getCFG());
+    Symbols += boost::size(M.symbols());
+  }
+  EXPECT_EQ(Blocks, Counts.Blocks);
+  EXPECT_EQ(Symbols, Counts.Symbols);
+  EXPECT_NE(Loaded->getAuxData("functions")->get<synthetic::FunctionTable>(),
+            nullptr);
+}